@@ -0,0 +1,62 @@
+#include <chrono>
+#include <iostream>
+#include <memory_resource>
+
+#include "deque.hpp"
+#include "../../stack_allocator_list/stack_allocator.hpp"
+
+// Per-request deques: each request builds a few small Deque<int>s, uses
+// them as queues and drops them. Compares std::allocator, a pmr monotonic
+// arena released per request, a pmr unsynchronized pool and the repo's
+// stack_allocator.
+namespace {
+const size_t kRequests = 200'000;
+
+volatile long long sink;
+
+template<typename Alloc, typename MakeAlloc, typename Reset>
+double run(MakeAlloc make_alloc, Reset reset) {
+  long long sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t request = 0; request < kRequests; ++request) {
+    {
+      Deque<int, 64, Alloc> pending{make_alloc()};
+      Deque<int, 64, Alloc> done{make_alloc()};
+      for (int i = 0; i < 100; ++i) {
+        pending.push_back(i);
+      }
+      while (pending.size() > 0) {
+        done.push_front(pending[0]);
+        pending.pop_front();
+      }
+      sum += done[0];
+    }
+    reset();
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  sink = sum;
+  return elapsed.count();
+}
+}
+
+int main() {
+  std::cout << kRequests << " requests, two 100-int deques each\n";
+  std::cout << "  std::allocator:   " << run<std::allocator<int>>([] { return std::allocator<int>(); }, [] {}) << " ms\n";
+
+  char buffer[64 * 1024];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+  std::cout << "  monotonic arena:  "
+            << run<std::pmr::polymorphic_allocator<int>>([&] { return std::pmr::polymorphic_allocator<int>(&arena); },
+                                                         [&] { arena.release(); })
+            << " ms\n";
+
+  std::pmr::unsynchronized_pool_resource pool;
+  std::cout << "  pool resource:    "
+            << run<std::pmr::polymorphic_allocator<int>>([&] { return std::pmr::polymorphic_allocator<int>(&pool); }, [] {})
+            << " ms\n";
+
+  auto storage = std::make_unique<stack_storage<64 * 1024>>();
+  std::cout << "  stack_allocator:  "
+            << run<stack_allocator<int, 64 * 1024>>([&] { return stack_allocator<int, 64 * 1024>(*storage); }, [] {})
+            << " ms\n";
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <malloc.h>
+#include <new>
+#include <vector>
+
+#include "deque.hpp"
+
+// Counts heap calls and peak heap bytes through a replaced global operator
+// new, then compares Deque<int> and std::deque<int> on push/pop throughput
+// and on many small deques, where lazy block allocation matters.
+namespace {
+size_t allocations = 0;
+size_t live_bytes = 0;
+size_t peak_bytes = 0;
+}
+
+void* operator new(size_t size) {
+  if (void* ptr = std::malloc(size)) {
+    ++allocations;
+    live_bytes += malloc_usable_size(ptr);
+    peak_bytes = std::max(peak_bytes, live_bytes);
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  if (ptr != nullptr) {
+    live_bytes -= malloc_usable_size(ptr);
+  }
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+
+namespace {
+void reset() {
+  allocations = 0;
+  peak_bytes = live_bytes;
+}
+
+template<typename Container>
+void run(const char* name, size_t count) {
+  reset();
+  auto start = std::chrono::steady_clock::now();
+  long long sum = 0;
+  {
+    Container container;
+    for (size_t i = 0; i < count; ++i) {
+      container.push_back(static_cast<int>(i));
+      container.push_front(static_cast<int>(i));
+    }
+    for (size_t i = 0; i < container.size(); ++i) {
+      sum += container[i];
+    }
+    while (!container.empty()) {
+      container.pop_back();
+    }
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "  " << name << ": " << elapsed.count() << " ms, " << allocations << " allocations, peak "
+            << peak_bytes / 1024 << " KiB" << (sum == 0 ? " " : "") << "\n";
+}
+
+template<typename Container>
+void run_small(const char* name, size_t count) {
+  reset();
+  size_t base = live_bytes;
+  auto start = std::chrono::steady_clock::now();
+  {
+    std::vector<Container> containers(count);
+    for (size_t i = 0; i < count; ++i) {
+      containers[i].push_back(static_cast<int>(i));
+      containers[i].push_back(static_cast<int>(i));
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "  " << name << ": " << elapsed.count() << " ms, " << allocations << " allocations, "
+              << (live_bytes - base) / 1024 << " KiB held\n";
+  }
+}
+
+template<typename T>
+struct Adapter : Deque<T> {
+  bool empty() const { return this->size() == 0; }
+};
+}
+
+int main() {
+  const size_t count = 5'000'000;
+  std::cout << "push_back + push_front " << count << " ints, index scan, pop all\n";
+  run<Adapter<int>>("Deque", count);
+  run<std::deque<int>>("std::deque", count);
+  const size_t small = 100'000;
+  std::cout << small << " deques of two ints\n";
+  run_small<Adapter<int>>("Deque", small);
+  run_small<std::deque<int>>("std::deque", small);
+}
@@ -0,0 +1,157 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "concurrent_deque.hpp"
+
+// Throughput of the concurrent deques against a mutex-guarded Deque.
+//
+// Task pool, 1..32 threads: every thread seeds its share of the tasks and
+// then drains work until all tasks have run. Each task spawns a child task
+// until its depth runs out, so the owner keeps pushing while others steal.
+// SPSC: one producer and one consumer pass ints through the queue.
+namespace {
+const int kRootTasks = 1 << 14;
+const int kDepth = 6;
+
+/// A task is just its remaining depth; running it spins briefly and spawns one child.
+void Work() {
+  volatile int spin = 0;
+  for (int i = 0; i < 50; ++i) {
+    spin = spin + i;
+  }
+}
+
+double StealingPool(int threads) {
+  std::vector<std::unique_ptr<WorkStealingDeque<int>>> deques;
+  for (int t = 0; t < threads; ++t) {
+    deques.emplace_back(new WorkStealingDeque<int>());
+  }
+  std::atomic<int> remaining{kRootTasks * (kDepth + 1)};
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      WorkStealingDeque<int>& own = *deques[t];
+      for (int i = t; i < kRootTasks; i += threads) {
+        own.push_back(kDepth);
+      }
+      unsigned victim = t;
+      int task = 0;
+      while (remaining.load(std::memory_order_relaxed) > 0) {
+        bool found = own.try_pop_back(task);
+        if (!found && threads > 1) {
+          victim = (victim * 1103515245 + 12345) % threads;
+          found = victim != static_cast<unsigned>(t) && deques[victim]->try_steal(task);
+        }
+        if (!found) {
+          continue;
+        }
+        Work();
+        if (task > 0) {
+          own.push_back(task - 1);
+        }
+        remaining.fetch_sub(1, std::memory_order_relaxed);
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+double MutexPool(int threads) {
+  Deque<int> shared;
+  std::mutex mutex;
+  std::atomic<int> remaining{kRootTasks * (kDepth + 1)};
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      for (int i = t; i < kRootTasks; i += threads) {
+        std::lock_guard<std::mutex> lock(mutex);
+        shared.push_back(kDepth);
+      }
+      int task = 0;
+      while (remaining.load(std::memory_order_relaxed) > 0) {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (shared.size() == 0) {
+            continue;
+          }
+          task = shared[shared.size() - 1];
+          shared.pop_back();
+        }
+        Work();
+        if (task > 0) {
+          std::lock_guard<std::mutex> lock(mutex);
+          shared.push_back(task - 1);
+        }
+        remaining.fetch_sub(1, std::memory_order_relaxed);
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+double Spsc(int count) {
+  SpscDeque<int> queue;
+  auto start = std::chrono::steady_clock::now();
+  std::thread producer([&] {
+    for (int i = 0; i < count; ++i) {
+      queue.push_back(i);
+    }
+  });
+  int out = 0;
+  for (int received = 0; received < count;) {
+    received += queue.try_pop_front(out) ? 1 : 0;
+  }
+  producer.join();
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+double MutexSpsc(int count) {
+  Deque<int> queue;
+  std::mutex mutex;
+  auto start = std::chrono::steady_clock::now();
+  std::thread producer([&] {
+    for (int i = 0; i < count; ++i) {
+      std::lock_guard<std::mutex> lock(mutex);
+      queue.push_back(i);
+    }
+  });
+  for (int received = 0; received < count;) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (queue.size() > 0) {
+      queue.pop_front();
+      ++received;
+    }
+  }
+  producer.join();
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+}
+
+int main() {
+  std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n";
+  std::cout << "task pool, " << kRootTasks * (kDepth + 1) << " tasks\n";
+  for (int threads : {1, 2, 4, 8, 16, 32}) {
+    std::cout << "  " << threads << " threads: work-stealing " << StealingPool(threads) << " ms, mutex Deque "
+              << MutexPool(threads) << " ms\n";
+  }
+  const int count = 10'000'000;
+  std::cout << "producer -> consumer, " << count << " ints\n";
+  std::cout << "  SpscDeque: " << Spsc(count) << " ms, mutex Deque: " << MutexSpsc(count) << " ms\n";
+}
@@ -0,0 +1,48 @@
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <vector>
+
+#include "deque.hpp"
+
+// Random access through operator[] and sequential iteration through
+// iterators, for Deque<int> and std::deque<int> of 4M elements.
+namespace {
+template<typename Container>
+void run(const char* name, const Container& container, const std::vector<size_t>& positions) {
+  long long sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t pos : positions) {
+    sum += container[pos];
+  }
+  std::chrono::duration<double, std::milli> random_access = std::chrono::steady_clock::now() - start;
+  start = std::chrono::steady_clock::now();
+  for (int round = 0; round < 10; ++round) {
+    for (auto it = container.begin(); it != container.end(); ++it) {
+      sum += *it;
+    }
+  }
+  std::chrono::duration<double, std::milli> sequential = std::chrono::steady_clock::now() - start;
+  std::cout << "  " << name << ": random " << random_access.count() << " ms, sequential x10 " << sequential.count()
+            << " ms" << (sum == 0 ? " " : "") << "\n";
+}
+}
+
+int main() {
+  const size_t count = 1 << 22;
+  Deque<int> deque;
+  std::deque<int> reference;
+  for (size_t i = 0; i < count; ++i) {
+    deque.push_back(static_cast<int>(i));
+    reference.push_back(static_cast<int>(i));
+  }
+  std::vector<size_t> positions(10'000'000);
+  unsigned state = 1;
+  for (size_t& pos : positions) {
+    state = state * 1103515245 + 12345;
+    pos = state % count;
+  }
+  std::cout << count << " ints, " << positions.size() << " random reads\n";
+  run("Deque", deque, positions);
+  run("std::deque", reference, positions);
+}
@@ -0,0 +1,62 @@
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "deque.hpp"
+
+// Heavy elements: a heap-backed string and a 256-byte struct with a
+// vector. Compares pushing copies of prepared values against pushing them
+// as rvalues, and middle inserts/erases, which relocate elements.
+namespace {
+struct Heavy {
+  std::array<char, 256> payload{};
+  std::vector<int> items;
+};
+
+template<typename T, typename Make>
+void run(const char* name, size_t count, Make make) {
+  std::vector<T> source;
+  for (size_t i = 0; i < count; ++i) {
+    source.push_back(make(i));
+  }
+  Deque<T> copies;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < count; ++i) {
+    copies.push_back(source[i]);
+  }
+  std::chrono::duration<double, std::milli> copied = std::chrono::steady_clock::now() - start;
+  Deque<T> moves;
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < count; ++i) {
+    moves.push_back(std::move(source[i]));
+  }
+  std::chrono::duration<double, std::milli> moved = std::chrono::steady_clock::now() - start;
+  start = std::chrono::steady_clock::now();
+  {
+    Deque<T> deque;
+    for (size_t i = 0; i < 2000; ++i) {
+      deque.push_back(make(i));
+    }
+    for (size_t i = 0; i < 2000; ++i) {
+      deque.insert(deque.begin() + 1000, make(i));
+      deque.erase(deque.begin() + 1000);
+    }
+  }
+  std::chrono::duration<double, std::milli> shifted = std::chrono::steady_clock::now() - start;
+  std::cout << "  " << name << ": push copy " << copied.count() << " ms, push rvalue " << moved.count()
+            << " ms, 2000 middle insert+erase " << shifted.count() << " ms\n";
+}
+}
+
+int main() {
+  const size_t count = 500'000;
+  std::cout << count << " elements\n";
+  run<std::string>("std::string", count, [](size_t i) { return std::string(64, static_cast<char>('a' + i % 26)); });
+  run<Heavy>("Heavy", count, [](size_t i) {
+    Heavy heavy;
+    heavy.items.assign(16, static_cast<int>(i));
+    return heavy;
+  });
+}
@@ -0,0 +1,83 @@
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <vector>
+
+#include "deque.hpp"
+
+// Inserts batches of 64 ints at random positions of a growing deque, once
+// one element at a time and once as a range insert, then erases them again
+// as ranges.
+namespace {
+double run_single(size_t batches, const std::vector<int>& batch) {
+  Deque<int> deque;
+  unsigned state = 1;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < batches; ++i) {
+    state = state * 1103515245 + 12345;
+    size_t pos = deque.size() == 0 ? 0 : state % deque.size();
+    for (size_t j = 0; j < batch.size(); ++j) {
+      deque.insert(deque.begin() + (pos + j), batch[j]);
+    }
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+double run_range(size_t batches, const std::vector<int>& batch) {
+  Deque<int> deque;
+  unsigned state = 1;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < batches; ++i) {
+    state = state * 1103515245 + 12345;
+    size_t pos = deque.size() == 0 ? 0 : state % deque.size();
+    deque.insert(deque.begin() + pos, batch.begin(), batch.end());
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+double run_std(size_t batches, const std::vector<int>& batch) {
+  std::deque<int> deque;
+  unsigned state = 1;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < batches; ++i) {
+    state = state * 1103515245 + 12345;
+    size_t pos = deque.size() == 0 ? 0 : state % deque.size();
+    deque.insert(deque.begin() + pos, batch.begin(), batch.end());
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+template<typename Container>
+double run_erase(size_t batches, const std::vector<int>& batch) {
+  Container deque;
+  for (size_t i = 0; i < batches; ++i) {
+    deque.insert(deque.end(), batch.begin(), batch.end());
+  }
+  unsigned state = 1;
+  auto start = std::chrono::steady_clock::now();
+  while (deque.size() >= batch.size()) {
+    state = state * 1103515245 + 12345;
+    size_t pos = state % (deque.size() - batch.size() + 1);
+    deque.erase(deque.begin() + pos, deque.begin() + (pos + batch.size()));
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+}
+
+int main() {
+  const size_t batches = 2000;
+  std::vector<int> batch(64);
+  for (size_t i = 0; i < batch.size(); ++i) {
+    batch[i] = static_cast<int>(i);
+  }
+  std::cout << batches << " batches of " << batch.size() << " ints at random positions\n";
+  std::cout << "  element-wise insert: " << run_single(batches, batch) << " ms\n";
+  std::cout << "  range insert:        " << run_range(batches, batch) << " ms\n";
+  std::cout << "  std::deque range:    " << run_std(batches, batch) << " ms\n";
+  std::cout << "  range erase:         " << run_erase<Deque<int>>(batches, batch) << " ms\n";
+  std::cout << "  std::deque erase:    " << run_erase<std::deque<int>>(batches, batch) << " ms\n";
+}
@@ -0,0 +1,52 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+#include "deque.hpp"
+
+// Scans a 10M-int Deque element by element through its iterators and
+// segment by segment, for accumulate, find (of a missing value), fill and
+// copy out.
+namespace {
+template<typename F>
+double time_ms(F f) {
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < 10; ++round) {
+    f();
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / 10;
+}
+
+void report(const char* name, double iterated, double segmented) {
+  std::cout << "  " << name << ": iterator " << iterated << " ms, segmented " << segmented << " ms, x"
+            << iterated / segmented << "\n";
+}
+}
+
+int main() {
+  const int count = 10'000'000;
+  Deque<int> deque;
+  for (int i = 0; i < count; ++i) {
+    deque.push_back(i % 1000);
+  }
+  std::vector<int> out(count);
+  volatile long long sink = 0;
+
+  std::cout << "scans over " << count << " ints\n";
+  report("accumulate",
+         time_ms([&] { sink = std::accumulate(deque.begin(), deque.end(), 0LL); }),
+         time_ms([&] { sink = ::accumulate(deque.begin(), deque.end(), 0LL); }));
+  report("find",
+         time_ms([&] { sink = std::find(deque.begin(), deque.end(), -1) - deque.begin(); }),
+         time_ms([&] { sink = ::find(deque.begin(), deque.end(), -1) - deque.begin(); }));
+  report("fill",
+         time_ms([&] { std::fill(deque.begin(), deque.end(), 3); }),
+         time_ms([&] { ::fill(deque.begin(), deque.end(), 3); }));
+  report("copy",
+         time_ms([&] { std::copy(deque.begin(), deque.end(), out.begin()); }),
+         time_ms([&] { ::copy(deque.begin(), deque.end(), out.begin()); }));
+  return static_cast<int>(sink & 0);
+}
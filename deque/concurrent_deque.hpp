@@ -0,0 +1,314 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "deque.hpp"
+
+
+/// ##################################################################################
+/// #############################  SpscDeque Declaration #############################
+/// ##################################################################################
+
+
+/// Unbounded single-producer/single-consumer queue over a chain of Deque-sized blocks. Both
+/// ends are wait-free apart from the producer allocating a block when none can be reused:
+/// blocks the consumer has left behind are recycled by the producer, so steady traffic runs
+/// without touching the allocator.
+template<typename T, size_t InnerSize = DequeBlockSize<T>()>
+class SpscDeque {
+public:
+  SpscDeque();
+
+  SpscDeque(const SpscDeque&) = delete;
+
+  SpscDeque& operator=(const SpscDeque&) = delete;
+
+  /// Producer side.
+  void push_back(const T& value);
+
+  void push_back(T&& value);
+
+  template<typename... Args>
+  void emplace_back(Args&&... args);
+
+  /// Consumer side. Moves the front element into `out`; false if the queue is empty.
+  bool try_pop_front(T& out);
+
+  ~SpscDeque();
+
+private:
+  struct Block {
+    std::atomic<size_t> written;
+    std::atomic<Block*> next;
+    alignas(T) unsigned char storage[sizeof(T) * InnerSize];
+
+    T* Slot(size_t index) { return reinterpret_cast<T*>(storage) + index; }
+  };
+
+  Block* NextFreeBlock();
+
+  static_assert(InnerSize > 0, "Deque block must hold at least one element");
+
+  static const size_t kInnerSize = InnerSize;
+  static const size_t kCacheLine = 64;
+
+  /// Consumer-owned.
+  alignas(kCacheLine) std::atomic<Block*> head_;
+  size_t read_;
+
+  /// Producer-owned. Blocks in [first_, head_copy_) have been left by the consumer.
+  alignas(kCacheLine) Block* tail_;
+  Block* first_;
+  Block* head_copy_;
+};
+
+
+/// ##########################################################################################
+/// #############################  WorkStealingDeque Declaration #############################
+/// ##########################################################################################
+
+
+/// Chase–Lev work-stealing deque (Lê et al., "Correct and Efficient Work-Stealing for Weak
+/// Memory Models"). The owning thread pushes and pops at the back; any thread may steal from
+/// the front. Thieves read a slot before claiming it, so T must be trivially copyable — store
+/// pointers or handles to larger tasks.
+template<typename T>
+class WorkStealingDeque {
+public:
+  explicit WorkStealingDeque(size_t capasity = DequeBlockSize<T>());
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  /// Owner only.
+  void push_back(const T& value);
+
+  /// Owner only. False if the deque is empty or a thief took the last element.
+  bool try_pop_back(T& out);
+
+  /// Any thread. False if the deque is empty or another thief won the race.
+  bool try_steal(T& out);
+
+  size_t size() const;
+
+private:
+  struct Ring {
+    explicit Ring(size_t capasity);
+
+    T Get(ptrdiff_t index) const { return slots[index & mask].load(std::memory_order_relaxed); }
+
+    void Put(ptrdiff_t index, const T& value) { slots[index & mask].store(value, std::memory_order_relaxed); }
+
+    size_t mask;
+    std::unique_ptr<std::atomic<T>[]> slots;
+  };
+
+  Ring* Grow(Ring* ring, ptrdiff_t top, ptrdiff_t bottom);
+
+  static_assert(std::is_trivially_copyable<T>::value, "WorkStealingDeque elements are copied racily");
+
+  static const size_t kCacheLine = 64;
+
+  alignas(kCacheLine) std::atomic<ptrdiff_t> top_;
+  alignas(kCacheLine) std::atomic<ptrdiff_t> bottom_;
+  std::atomic<Ring*> ring_;
+  /// Outgrown rings stay alive: a thief may still be reading one.
+  std::vector<std::unique_ptr<Ring>> rings_;
+};
+
+
+/// ##################################################################################
+/// #############################  SpscDeque Realization #############################
+/// ##################################################################################
+
+
+template<typename T, size_t InnerSize>
+SpscDeque<T, InnerSize>::SpscDeque() : head_(new Block{{0}, {nullptr}, {}}), read_(0) {
+  tail_ = head_.load(std::memory_order_relaxed);
+  first_ = tail_;
+  head_copy_ = tail_;
+}
+
+template<typename T, size_t InnerSize>
+void SpscDeque<T, InnerSize>::push_back(const T& value) { emplace_back(value); }
+
+template<typename T, size_t InnerSize>
+void SpscDeque<T, InnerSize>::push_back(T&& value) { emplace_back(std::move(value)); }
+
+template<typename T, size_t InnerSize>
+template<typename... Args>
+void SpscDeque<T, InnerSize>::emplace_back(Args&&... args) {
+  size_t written = tail_->written.load(std::memory_order_relaxed);
+  if (written < kInnerSize) {
+    new(tail_->Slot(written)) T(std::forward<Args>(args)...);
+    tail_->written.store(written + 1, std::memory_order_release);
+    return;
+  }
+  Block* block = NextFreeBlock();
+  try {
+    new(block->Slot(0)) T(std::forward<Args>(args)...);
+  } catch (...) {
+    block->next.store(first_, std::memory_order_relaxed);
+    first_ = block;
+    throw;
+  }
+  block->written.store(1, std::memory_order_relaxed);
+  tail_->next.store(block, std::memory_order_release);
+  tail_ = block;
+}
+
+/// Reuses the oldest block the consumer has moved past, or allocates a fresh one.
+template<typename T, size_t InnerSize>
+typename SpscDeque<T, InnerSize>::Block* SpscDeque<T, InnerSize>::NextFreeBlock() {
+  if (first_ == head_copy_) {
+    head_copy_ = head_.load(std::memory_order_acquire);
+  }
+  if (first_ == head_copy_) {
+    return new Block{{0}, {nullptr}, {}};
+  }
+  Block* block = first_;
+  first_ = first_->next.load(std::memory_order_relaxed);
+  block->written.store(0, std::memory_order_relaxed);
+  block->next.store(nullptr, std::memory_order_relaxed);
+  return block;
+}
+
+template<typename T, size_t InnerSize>
+bool SpscDeque<T, InnerSize>::try_pop_front(T& out) {
+  Block* block = head_.load(std::memory_order_relaxed);
+  if (read_ == kInnerSize) {
+    Block* next = block->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      return false;
+    }
+    head_.store(next, std::memory_order_release);
+    block = next;
+    read_ = 0;
+  }
+  if (read_ == block->written.load(std::memory_order_acquire)) {
+    return false;
+  }
+  T* slot = block->Slot(read_);
+  out = std::move(*slot);
+  slot->~T();
+  ++read_;
+  return true;
+}
+
+template<typename T, size_t InnerSize>
+SpscDeque<T, InnerSize>::~SpscDeque() {
+  Block* block = head_.load(std::memory_order_relaxed);
+  for (size_t i = read_; i < block->written.load(std::memory_order_relaxed); ++i) {
+    block->Slot(i)->~T();
+  }
+  for (block = block->next.load(std::memory_order_relaxed); block != nullptr;
+       block = block->next.load(std::memory_order_relaxed)) {
+    for (size_t i = 0; i < block->written.load(std::memory_order_relaxed); ++i) {
+      block->Slot(i)->~T();
+    }
+  }
+  Block* head = head_.load(std::memory_order_relaxed);
+  while (first_ != head) {
+    Block* next = first_->next.load(std::memory_order_relaxed);
+    delete first_;
+    first_ = next;
+  }
+  while (head != nullptr) {
+    Block* next = head->next.load(std::memory_order_relaxed);
+    delete head;
+    head = next;
+  }
+}
+
+
+/// ##########################################################################################
+/// #############################  WorkStealingDeque Realization #############################
+/// ##########################################################################################
+
+
+template<typename T>
+WorkStealingDeque<T>::Ring::Ring(size_t capasity) : mask(capasity - 1), slots(new std::atomic<T>[capasity]) {}
+
+template<typename T>
+WorkStealingDeque<T>::WorkStealingDeque(size_t capasity) : top_(0), bottom_(0), ring_(nullptr) {
+  size_t power = 1;
+  while (power < capasity) {
+    power *= 2;
+  }
+  rings_.emplace_back(new Ring(power));
+  ring_.store(rings_.back().get(), std::memory_order_relaxed);
+}
+
+template<typename T>
+typename WorkStealingDeque<T>::Ring* WorkStealingDeque<T>::Grow(Ring* ring, ptrdiff_t top, ptrdiff_t bottom) {
+  rings_.emplace_back(new Ring((ring->mask + 1) * 2));
+  Ring* fresh = rings_.back().get();
+  for (ptrdiff_t i = top; i < bottom; ++i) {
+    fresh->Put(i, ring->Get(i));
+  }
+  ring_.store(fresh, std::memory_order_release);
+  return fresh;
+}
+
+template<typename T>
+void WorkStealingDeque<T>::push_back(const T& value) {
+  ptrdiff_t bottom = bottom_.load(std::memory_order_relaxed);
+  ptrdiff_t top = top_.load(std::memory_order_acquire);
+  Ring* ring = ring_.load(std::memory_order_relaxed);
+  if (bottom - top > static_cast<ptrdiff_t>(ring->mask)) {
+    ring = Grow(ring, top, bottom);
+  }
+  ring->Put(bottom, value);
+  std::atomic_thread_fence(std::memory_order_release);
+  bottom_.store(bottom + 1, std::memory_order_relaxed);
+}
+
+template<typename T>
+bool WorkStealingDeque<T>::try_pop_back(T& out) {
+  ptrdiff_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+  Ring* ring = ring_.load(std::memory_order_relaxed);
+  bottom_.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  ptrdiff_t top = top_.load(std::memory_order_relaxed);
+  if (top > bottom) {
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return false;
+  }
+  out = ring->Get(bottom);
+  if (top == bottom) {
+    bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return won;
+  }
+  return true;
+}
+
+template<typename T>
+bool WorkStealingDeque<T>::try_steal(T& out) {
+  ptrdiff_t top = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  ptrdiff_t bottom = bottom_.load(std::memory_order_acquire);
+  if (top >= bottom) {
+    return false;
+  }
+  T value = ring_.load(std::memory_order_acquire)->Get(top);
+  if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+    return false;
+  }
+  out = value;
+  return true;
+}
+
+template<typename T>
+size_t WorkStealingDeque<T>::size() const {
+  ptrdiff_t bottom = bottom_.load(std::memory_order_relaxed);
+  ptrdiff_t top = top_.load(std::memory_order_relaxed);
+  return bottom > top ? bottom - top : 0;
+}
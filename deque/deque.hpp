@@ -1,34 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
 #include <type_traits>
 #include <iostream>
-
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+#include <stdexcept>
+
+/// Elements per block: about 16 elements, clamped to 512 B .. 4 KiB, rounded down to a power of two.
 template<typename T>
+constexpr size_t DequeBlockSize() {
+  size_t bytes = sizeof(T) * 16;
+  bytes = bytes < 512 ? 512 : (bytes > 4096 ? 4096 : bytes);
+  size_t count = bytes / sizeof(T) == 0 ? 1 : bytes / sizeof(T);
+  size_t power = 1;
+  while (power * 2 <= count) {
+    power *= 2;
+  }
+  return power;
+}
+
+template<typename T, size_t InnerSize = DequeBlockSize<typename std::remove_const<T>::type>()>
 class DequeIterator;
 
+template<typename T, size_t InnerSize, typename F>
+void for_each_segment(DequeIterator<T, InnerSize> first, DequeIterator<T, InnerSize> last, F f);
+
 
 /// ################################################################################
 /// #############################  Dequeue Declaration #############################
 /// ################################################################################
 
 
-template<typename T>
+template<typename T, size_t InnerSize = DequeBlockSize<T>(), typename Allocator = std::allocator<T>>
 struct Deque {
+  using block_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+  using block_traits = std::allocator_traits<block_allocator>;
+  using map_allocator = typename block_traits::template rebind_alloc<T*>;
+  using map_traits = std::allocator_traits<map_allocator>;
+
 public:
-  Deque();
+  using iterator = DequeIterator<T, InnerSize>;
+  using const_iterator = DequeIterator<const T, InnerSize>;
+  using allocator_type = Allocator;
+
+  Deque() noexcept(noexcept(Allocator()));
+
+  explicit Deque(const Allocator& alloc) noexcept;
 
   Deque(const Deque& other);
 
-  explicit Deque(int quantity);
+  Deque(const Deque& other, const Allocator& alloc);
 
-  Deque(int quantity, const T& element);
+  Deque(Deque&& other) noexcept;
+
+  explicit Deque(int quantity, const Allocator& alloc = Allocator());
+
+  Deque(int quantity, const T& element, const Allocator& alloc = Allocator());
 
   Deque& operator=(const Deque& other);
 
+  Deque& operator=(Deque&& other) noexcept(
+      block_traits::propagate_on_container_move_assignment::value || block_traits::is_always_equal::value);
+
+  Allocator get_allocator() const;
+
   size_t size() const;
 
   void push_back(const T& value);
 
+  void push_back(T&& value);
+
   void push_front(const T& value);
 
+  void push_front(T&& value);
+
+  template<typename... Args>
+  T& emplace_back(Args&&... args);
+
+  template<typename... Args>
+  T& emplace_front(Args&&... args);
+
   void pop_back();
 
   void pop_front();
@@ -41,63 +99,145 @@ public:
 
   const T& at(size_t pos) const;
 
-  DequeIterator<T> begin();
+  DequeIterator<T, InnerSize> begin();
 
-  DequeIterator<T> end();
+  DequeIterator<T, InnerSize> end();
 
-  DequeIterator<const T> begin() const;
+  DequeIterator<const T, InnerSize> begin() const;
 
-  DequeIterator<const T> end() const;
+  DequeIterator<const T, InnerSize> end() const;
 
-  DequeIterator<const T> cbegin() const;
+  DequeIterator<const T, InnerSize> cbegin() const;
 
-  DequeIterator<const T> cend() const;
+  DequeIterator<const T, InnerSize> cend() const;
 
-  DequeIterator<T> rbegin();
+  DequeIterator<T, InnerSize> rbegin();
 
-  DequeIterator<T> rend();
+  DequeIterator<T, InnerSize> rend();
 
-  DequeIterator<const T> rbegin() const;
+  DequeIterator<const T, InnerSize> rbegin() const;
 
-  DequeIterator<const T> rend() const;
+  DequeIterator<const T, InnerSize> rend() const;
 
-  DequeIterator<const T> crbegin() const;
+  DequeIterator<const T, InnerSize> crbegin() const;
 
-  DequeIterator<const T> crend() const;
+  DequeIterator<const T, InnerSize> crend() const;
 
-  void insert(const DequeIterator<T>& it, const T& elem);
+  void insert(const DequeIterator<T, InnerSize>& it, const T& elem);
 
-  void erase(const DequeIterator<T>& it);
+  void insert(const DequeIterator<T, InnerSize>& it, T&& elem);
 
-  ~Deque();
+  template<typename... Args>
+  void emplace(const DequeIterator<T, InnerSize>& it, Args&&... args);
 
-  using iterator = DequeIterator<T>;
-  using const_iterator = DequeIterator<const T>;
+  void erase(const DequeIterator<T, InnerSize>& it);
 
-  friend DequeIterator<T>& DequeIterator<T>::operator++();
+  template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  void insert(const DequeIterator<T, InnerSize>& it, InputIt first, InputIt last);
 
-  friend DequeIterator<T>& DequeIterator<T>::operator--();
+  void erase(const DequeIterator<T, InnerSize>& first, const DequeIterator<T, InnerSize>& last);
 
-  friend void DequeIterator<T>::Increase();
+  template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  void append(InputIt first, InputIt last);
 
-  friend void DequeIterator<T>::Decrease();
+  void append(std::span<const T> items);
 
-  friend class DequeIterator<T>;
+  template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  void prepend(InputIt first, InputIt last);
 
-  friend class DequeIterator<const T>;
+  void prepend(std::span<const T> items);
+
+  template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  void assign(InputIt first, InputIt last);
+
+  void assign(size_t count, const T& value);
+
+  void resize(size_t count);
+
+  void resize(size_t count, const T& value);
+
+  /// Frees every block outside the live range and trims the map to fit.
+  void shrink_to_fit();
+
+  /// Reclaim policy: once more than `blocks` allocated blocks hold no elements, blocks
+  /// vacated by pop_front/pop_back are freed instead of kept for reuse. Unlimited by default,
+  /// which keeps steady FIFO traffic allocation-free.
+  void set_spare_block_limit(size_t blocks);
+
+  /// Heap bytes held: allocated blocks plus the block map.
+  size_t memory_usage() const;
+
+  template<typename F>
+  void for_each_segment(F f);
+
+  template<typename F>
+  void for_each_segment(F f) const;
+
+  ~Deque();
+
+  friend class DequeIterator<T, InnerSize>;
+
+  friend class DequeIterator<const T, InnerSize>;
 
 private:
+  void MakeRoom(size_t extra);
+
+  void ReserveBack(size_t count);
+
+  void ReserveFront(size_t count);
+
+  void MoveRange(size_t destination, size_t source, size_t count);
+
+  void DropFront(size_t count);
+
+  void DropBack(size_t count);
+
+  template<typename ForwardIt>
+  void CopyIn(size_t pos, ForwardIt first, size_t count);
+
+  template<typename... Args>
+  void GrowBack(size_t count, const Args&... args);
+
   void Expand();
 
+  void Recenter(size_t first, size_t live);
+
   void Delete();
 
-  static const size_t kInnerSize = 8;
+  T* Touch(size_t block);
+
+  void Release(size_t block);
+
+  size_t LiveBlocks() const;
+
+  T** BlockOf(size_t pos) const;
+
+  T** NewMap(size_t size);
+
+  void DeleteMap(T** map, size_t size);
+
+  void Swap(Deque& other);
+
+  static void Relocate(T& destination, T& source);
+
+  static const bool kMoveOnRelocate = std::is_nothrow_move_assignable<T>::value || !std::is_copy_assignable<T>::value;
+  static const bool kMemmovable = std::is_trivially_copyable<T>::value;
+
+  static_assert(std::has_single_bit(InnerSize), "Deque block size must be a power of two");
+
+  static const size_t kInnerSize = InnerSize;
+  static const size_t kShift = std::countr_zero(InnerSize);
+  static const size_t kMask = InnerSize - 1;
   static const size_t kDefaultOuterSize = 2;
+  static const size_t kNoLimit = static_cast<size_t>(-1);
 
+  [[no_unique_address]] block_allocator alloc_;
   size_t outer_size_;
   T** outer_;
   size_t start_;
   size_t finish_;
+  size_t blocks_;
+  size_t spare_limit_;
 };
 
 
@@ -106,11 +246,11 @@ private:
 /// ########################################################################################
 
 
-template<typename T>
+template<typename T, size_t InnerSize>
 class DequeIterator {
 public:
-  operator DequeIterator<const T>() {
-    return DequeIterator<const T>(position_, outer_pointer_, is_reverse_);
+  operator DequeIterator<const T, InnerSize>() {
+    return DequeIterator<const T, InnerSize>(position_, outer_pointer_, is_reverse_);
   }
 
   DequeIterator& operator++();
@@ -133,17 +273,15 @@ public:
 
   int operator-(const DequeIterator<const typename std::remove_const<T>>& other) const;
 
-  T& operator*();
-
-  const T& operator*() const;
+  T& operator*() const;
 
-  T* operator->();
+  T* operator->() const;
 
-  const T* operator->() const;
+  template<typename U, size_t N, typename A>
+  friend struct Deque;
 
-  friend struct Deque<T>;
-
-  friend struct Deque<typename std::remove_const<T>::type>;
+  template<typename U, size_t N>
+  friend class SnapshotDeque;
 
   using value_type = T;
   using difference_type = int;
@@ -158,14 +296,30 @@ private:
 
   int Subtract(const DequeIterator& other) const;
 
+  void Seek(size_t pos);
+
+  static T* Locate(T** outer, size_t pos);
+
   DequeIterator(size_t pos, T** outer, bool rev);
 
+  static const size_t kInnerSize = InnerSize;
+  static const size_t kShift = std::countr_zero(InnerSize);
+  static const size_t kMask = InnerSize - 1;
+
+  /// current_ caches the element address, so dereferencing never touches the map.
+  T* current_;
   size_t position_;
   T** outer_pointer_;
   bool is_reverse_;
 
-  template<typename U>
-  friend bool operator<(const DequeIterator<U>& first, const DequeIterator<U>& second);
+  template<typename U, size_t N>
+  friend bool operator<(const DequeIterator<U, N>& first, const DequeIterator<U, N>& second);
+
+  template<typename U, size_t N>
+  friend bool operator==(const DequeIterator<U, N>& first, const DequeIterator<U, N>& second);
+
+  template<typename U, size_t N, typename F>
+  friend void for_each_segment(DequeIterator<U, N> first, DequeIterator<U, N> last, F f);
 };
 
 
@@ -174,292 +328,766 @@ private:
 /// ################################################################################
 
 
-template<typename T>
-void Deque<T>::Expand() {
-  auto destination = new T*[outer_size_ * 2];
-  for (size_t i = 0; i < outer_size_ / 2; ++i) {
-    destination[i] = reinterpret_cast<T*>(new char[sizeof(T) * kInnerSize]);
+/// Called when one end of the map is exhausted. If the live blocks fill at most half of the
+/// map, the map is rotated instead of grown: the spare (already allocated) blocks that
+/// pop_front/pop_back left behind come round to the exhausted end, so steady FIFO traffic
+/// reuses the same blocks and never reallocates the map.
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::MakeRoom(size_t extra) {
+  size_t first = start_ / kInnerSize;
+  size_t live = (finish_ + kInnerSize) / kInnerSize - first;
+  if (outer_size_ != 0 && 2 * (live + extra) <= outer_size_) {
+    Recenter(first, live);
+  } else {
+    Expand();
   }
-  for (size_t i = outer_size_ / 2; i <= outer_size_ / 2 + finish_ / kInnerSize - start_ / kInnerSize; ++i) {
-    destination[i] = outer_[i - outer_size_ / 2 + start_ / kInnerSize];
+}
+
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::Recenter(size_t first, size_t live) {
+  size_t target = (outer_size_ - live) / 2;
+  if (target < first) {
+    std::rotate(outer_, outer_ + (first - target), outer_ + outer_size_);
+    start_ -= (first - target) * kInnerSize;
+    finish_ -= (first - target) * kInnerSize;
+  } else {
+    std::rotate(outer_, outer_ + outer_size_ - (target - first), outer_ + outer_size_);
+    start_ += (target - first) * kInnerSize;
+    finish_ += (target - first) * kInnerSize;
   }
-  for (size_t i = outer_size_ / 2 + finish_ / kInnerSize - start_ / kInnerSize + 1; i < outer_size_ * 2; ++i) {
-    destination[i] = reinterpret_cast<T*>(new char[sizeof(T) * kInnerSize]);
+}
+
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::Expand() {
+  size_t new_size = outer_size_ == 0 ? kDefaultOuterSize : outer_size_ * 2;
+  T** destination = NewMap(new_size);
+  size_t shift = (new_size - outer_size_) / 2;
+  for (size_t i = 0; i < outer_size_; ++i) {
+    destination[i + shift] = outer_[i];
   }
-  finish_ = (outer_size_ / 2 + finish_ / kInnerSize - start_ / kInnerSize) * kInnerSize + finish_ % kInnerSize;
-  start_ = (outer_size_ / 2) * kInnerSize + start_ % kInnerSize;
-  delete[] outer_;
+  start_ += shift * kInnerSize;
+  finish_ += shift * kInnerSize;
+  DeleteMap(outer_, outer_size_);
   outer_ = destination;
-  outer_size_ *= 2;
+  outer_size_ = new_size;
 }
 
-template<typename T>
-void Deque<T>::Delete() {
-  if (finish_ >= start_) {
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::Delete() {
+  if (finish_ + 1 != start_) {
     for (size_t j = 0; j <= finish_ - start_; ++j) {
-      (*this)[j].~T();
+      block_traits::destroy(alloc_, &(*this)[j]);
     }
   }
   for (size_t i = 0; i < outer_size_; ++i) {
-    delete[] reinterpret_cast<char*>(outer_[i]);
+    if (outer_[i] != nullptr) {
+      block_traits::deallocate(alloc_, outer_[i], kInnerSize);
+    }
   }
-  delete[] outer_;
+  DeleteMap(outer_, outer_size_);
 }
 
+/// Blocks spanned by [start_, finish_]; zero when empty.
+template<typename T, size_t InnerSize, typename Allocator>
+size_t Deque<T, InnerSize, Allocator>::LiveBlocks() const {
+  return finish_ + 1 == start_ ? 0 : (finish_ >> kShift) - (start_ >> kShift) + 1;
+}
 
-template<typename T>
-Deque<T>::Deque() : outer_size_(kDefaultOuterSize), outer_(new T*[outer_size_]),
-                    start_(kInnerSize * kDefaultOuterSize / 2), finish_(start_ - 1) {
-  for (size_t i = 0; i < outer_size_; ++i) {
-    outer_[i] = reinterpret_cast<T*>(new char[sizeof(T) * kInnerSize]);
+/// Frees a block that holds no elements if the spare-block limit is exceeded.
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::Release(size_t block) {
+  if (blocks_ - LiveBlocks() > spare_limit_ && outer_[block] != nullptr) {
+    block_traits::deallocate(alloc_, outer_[block], kInnerSize);
+    outer_[block] = nullptr;
+    --blocks_;
   }
 }
 
-template<typename T>
-Deque<T>::Deque(const Deque& other) : outer_size_(other.outer_size_), outer_(new T*[outer_size_]),
-                                      start_(other.start_), finish_(other.finish_) {
-  for (size_t i = 0; i < outer_size_; ++i) {
-    outer_[i] = reinterpret_cast<T*>(new char[sizeof(T) * kInnerSize]);
+/// Blocks are allocated the first time an element lands in them.
+template<typename T, size_t InnerSize, typename Allocator>
+T* Deque<T, InnerSize, Allocator>::Touch(size_t block) {
+  if (outer_[block] == nullptr) {
+    outer_[block] = block_traits::allocate(alloc_, kInnerSize);
+    ++blocks_;
   }
-  size_t pos;
+  return outer_[block];
+}
+
+/// Block slot of an absolute position, including the sentinel slots either side of the map
+/// that end() and rend() may sit in. Positions just below zero (rend of a deque starting at 0)
+/// wrap, so they are shifted as signed.
+template<typename T, size_t InnerSize, typename Allocator>
+T** Deque<T, InnerSize, Allocator>::BlockOf(size_t pos) const {
+  return outer_ == nullptr ? nullptr : outer_ + (static_cast<ptrdiff_t>(pos) >> kShift);
+}
+
+/// Maps carry one null slot before and after the live range, so an iterator stepping onto
+/// end() or rend() can always read its block pointer.
+template<typename T, size_t InnerSize, typename Allocator>
+T** Deque<T, InnerSize, Allocator>::NewMap(size_t size) {
+  map_allocator map_alloc(alloc_);
+  T** map = map_traits::allocate(map_alloc, size + 2);
+  std::fill_n(map, size + 2, nullptr);
+  return map + 1;
+}
+
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::DeleteMap(T** map, size_t size) {
+  if (map != nullptr) {
+    map_allocator map_alloc(alloc_);
+    map_traits::deallocate(map_alloc, map - 1, size + 2);
+  }
+}
+
+/// Makes positions finish_ + 1 .. finish_ + count addressable and backed by allocated blocks.
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::ReserveBack(size_t count) {
+  if (count == 0) {
+    return;
+  }
+  while (outer_size_ * kInnerSize - 1 - finish_ < count) {
+    MakeRoom(count / kInnerSize + 1);
+  }
+  for (size_t block = (finish_ + 1) / kInnerSize; block <= (finish_ + count) / kInnerSize; ++block) {
+    Touch(block);
+  }
+}
+
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::ReserveFront(size_t count) {
+  if (count == 0) {
+    return;
+  }
+  while (start_ < count) {
+    MakeRoom(count / kInnerSize + 1);
+  }
+  for (size_t block = (start_ - count) / kInnerSize; block < (start_ + kInnerSize - 1) / kInnerSize; ++block) {
+    Touch(block);
+  }
+}
+
+/// memmove between absolute positions, one block-contiguous segment at a time. Only for
+/// trivially copyable T; the ranges may overlap and the destination may be raw storage.
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::MoveRange(size_t destination, size_t source, size_t count) {
+  if (destination < source) {
+    for (size_t done = 0; done < count;) {
+      size_t from = source + done;
+      size_t to = destination + done;
+      size_t segment = std::min({count - done, kInnerSize - from % kInnerSize, kInnerSize - to % kInnerSize});
+      std::memmove(outer_[to / kInnerSize] + to % kInnerSize, outer_[from / kInnerSize] + from % kInnerSize,
+                   segment * sizeof(T));
+      done += segment;
+    }
+  } else if (destination > source) {
+    for (size_t left = count; left > 0;) {
+      size_t from = source + left - 1;
+      size_t to = destination + left - 1;
+      size_t segment = std::min({left, from % kInnerSize + 1, to % kInnerSize + 1});
+      std::memmove(outer_[to / kInnerSize] + to % kInnerSize + 1 - segment,
+                   outer_[from / kInnerSize] + from % kInnerSize + 1 - segment, segment * sizeof(T));
+      left -= segment;
+    }
+  }
+}
+
+/// Destroys the first `count` elements, then offers every block they vacated to Release(),
+/// as that many pop_front() calls would.
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::DropFront(size_t count) {
+  if constexpr (!std::is_trivially_destructible<T>::value) {
+    for (size_t pos = start_; pos < start_ + count; ++pos) {
+      block_traits::destroy(alloc_, outer_[pos >> kShift] + (pos & kMask));
+    }
+  }
+  size_t first_block = start_ >> kShift;
+  start_ += count;
+  for (size_t block = first_block; block < (start_ >> kShift); ++block) {
+    Release(block);
+  }
+}
+
+/// The pop_back() counterpart of DropFront().
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::DropBack(size_t count) {
+  if constexpr (!std::is_trivially_destructible<T>::value) {
+    for (size_t pos = finish_ + 1 - count; pos <= finish_; ++pos) {
+      block_traits::destroy(alloc_, outer_[pos >> kShift] + (pos & kMask));
+    }
+  }
+  size_t last_block = finish_ >> kShift;
+  finish_ -= count;
+  for (size_t block = (finish_ + kInnerSize) >> kShift; block <= last_block; ++block) {
+    Release(block);
+  }
+}
+
+/// Copies `count` elements into the reserved positions starting at `pos`, block by block.
+template<typename T, size_t InnerSize, typename Allocator>
+template<typename ForwardIt>
+void Deque<T, InnerSize, Allocator>::CopyIn(size_t pos, ForwardIt first, size_t count) {
+  for (size_t done = 0; done < count;) {
+    size_t to = pos + done;
+    size_t segment = std::min(count - done, kInnerSize - to % kInnerSize);
+    std::copy_n(first, segment, outer_[to / kInnerSize] + to % kInnerSize);
+    std::advance(first, segment);
+    done += segment;
+  }
+}
+
+/// Appends `count` elements constructed from `args`; rolls back on exception.
+template<typename T, size_t InnerSize, typename Allocator>
+template<typename... Args>
+void Deque<T, InnerSize, Allocator>::GrowBack(size_t count, const Args&... args) {
+  ReserveBack(count);
+  size_t old_size = size();
   try {
-    for (pos = start_; pos <= finish_; ++pos) {
-      new(outer_[pos / kInnerSize] + pos % kInnerSize) T(other[pos - start_]);
+    for (size_t i = 0; i < count; ++i) {
+      size_t pos = finish_ + 1;
+      block_traits::construct(alloc_, outer_[pos / kInnerSize] + pos % kInnerSize, args...);
+      ++finish_;
     }
   } catch (...) {
-    finish_ = pos - 1;
-    Delete();
+    while (size() > old_size) {
+      pop_back();
+    }
     throw;
   }
 }
 
-template<typename T>
-Deque<T>::Deque(int quantity) : outer_size_((quantity / kInnerSize + 1) * 2), outer_(new T*[outer_size_]),
-                                start_(kInnerSize * kDefaultOuterSize / 2), finish_(start_ + quantity - 1) {
-  for (size_t i = 0; i < outer_size_; ++i) {
-    outer_[i] = reinterpret_cast<T*>(new char[sizeof(T) * kInnerSize]);
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::Swap(Deque& other) {
+  std::swap(alloc_, other.alloc_);
+  std::swap(outer_size_, other.outer_size_);
+  std::swap(outer_, other.outer_);
+  std::swap(start_, other.start_);
+  std::swap(finish_, other.finish_);
+  std::swap(blocks_, other.blocks_);
+  std::swap(spare_limit_, other.spare_limit_);
+}
+
+/// Moves when that cannot throw (or when T cannot be copied at all), copies otherwise.
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::Relocate(T& destination, T& source) {
+  if constexpr (kMoveOnRelocate) {
+    destination = std::move(source);
+  } else {
+    destination = source;
   }
-  size_t pos;
+}
+
+
+/// An empty Deque owns no map at all; the first push allocates it through Expand().
+template<typename T, size_t InnerSize, typename Allocator>
+Deque<T, InnerSize, Allocator>::Deque() noexcept(noexcept(Allocator()))
+    : alloc_(), outer_size_(0), outer_(nullptr), start_(0), finish_(start_ - 1), blocks_(0), spare_limit_(kNoLimit) {}
+
+template<typename T, size_t InnerSize, typename Allocator>
+Deque<T, InnerSize, Allocator>::Deque(const Allocator& alloc) noexcept
+    : alloc_(alloc), outer_size_(0), outer_(nullptr), start_(0), finish_(start_ - 1), blocks_(0), spare_limit_(kNoLimit) {}
+
+template<typename T, size_t InnerSize, typename Allocator>
+Deque<T, InnerSize, Allocator>::Deque(const Deque& other)
+    : Deque(other, Allocator(block_traits::select_on_container_copy_construction(other.alloc_))) {}
+
+/// Copying an empty Deque leaves the copy in the map-less empty state too.
+template<typename T, size_t InnerSize, typename Allocator>
+Deque<T, InnerSize, Allocator>::Deque(const Deque& other, const Allocator& alloc)
+    : alloc_(alloc), outer_size_(0), outer_(nullptr), start_(0), finish_(start_ - 1), blocks_(0),
+      spare_limit_(other.spare_limit_) {
+  if (other.size() == 0) {
+    return;
+  }
+  outer_ = NewMap(other.outer_size_);
+  outer_size_ = other.outer_size_;
+  start_ = other.start_;
+  finish_ = start_ - 1;
   try {
-    for (pos = start_; pos <= finish_; ++pos) {
-      new(outer_[pos / kInnerSize] + pos % kInnerSize) T();
+    for (size_t i = 0; i < other.size(); ++i) {
+      size_t pos = start_ + i;
+      block_traits::construct(alloc_, Touch(pos / kInnerSize) + pos % kInnerSize, other[i]);
+      ++finish_;
     }
   } catch (...) {
-    finish_ = pos - 1;
+    Delete();
+    throw;
   }
 }
 
-template<typename T>
-Deque<T>::Deque(int quantity, const T& element) : outer_size_((quantity / kInnerSize + 1) * 2), outer_(new T*[outer_size_]),
-                                                  start_(kInnerSize * kDefaultOuterSize / 2), finish_(start_ + quantity - 1) {
-  for (size_t i = 0; i < outer_size_; ++i) {
-    outer_[i] = reinterpret_cast<T*>(new char[sizeof(T) * kInnerSize]);
-  }
-  size_t pos;
+template<typename T, size_t InnerSize, typename Allocator>
+Deque<T, InnerSize, Allocator>::Deque(Deque&& other) noexcept
+    : alloc_(std::move(other.alloc_)), outer_size_(other.outer_size_), outer_(other.outer_), start_(other.start_),
+      finish_(other.finish_), blocks_(other.blocks_), spare_limit_(other.spare_limit_) {
+  other.outer_size_ = 0;
+  other.outer_ = nullptr;
+  other.start_ = 0;
+  other.finish_ = other.start_ - 1;
+  other.blocks_ = 0;
+}
+
+template<typename T, size_t InnerSize, typename Allocator>
+Deque<T, InnerSize, Allocator>::Deque(int quantity, const Allocator& alloc)
+    : alloc_(alloc), outer_size_((quantity / kInnerSize + 1) * 2), outer_(NewMap(outer_size_)),
+      start_(kInnerSize * kDefaultOuterSize / 2), finish_(start_ - 1), blocks_(0), spare_limit_(kNoLimit) {
   try {
-    for (pos = start_; pos <= finish_; ++pos) {
-      new(outer_[pos / kInnerSize] + pos % kInnerSize) T(element);
+    for (size_t pos = start_; pos < start_ + quantity; ++pos) {
+      block_traits::construct(alloc_, Touch(pos / kInnerSize) + pos % kInnerSize);
+      ++finish_;
     }
   } catch (...) {
-    finish_ = pos - 1;
     Delete();
     throw;
   }
 }
 
-template<typename T>
-Deque<T>& Deque<T>::operator=(const Deque& other) {
-  T** buffer = outer_;
-  outer_ = new T*[other.outer_size_];
-  for (size_t i = 0; i < other.outer_size_; ++i) {
-    outer_[i] = reinterpret_cast<T*>(new char[sizeof(T) * kInnerSize]);
-  }
-  size_t pos;
+template<typename T, size_t InnerSize, typename Allocator>
+Deque<T, InnerSize, Allocator>::Deque(int quantity, const T& element, const Allocator& alloc)
+    : alloc_(alloc), outer_size_((quantity / kInnerSize + 1) * 2), outer_(NewMap(outer_size_)),
+      start_(kInnerSize * kDefaultOuterSize / 2), finish_(start_ - 1), blocks_(0), spare_limit_(kNoLimit) {
   try {
-    for (pos = other.start_; pos <= other.finish_; ++pos) {
-      new(outer_[pos / kInnerSize] + pos % kInnerSize) T(other[pos - other.start_]);
+    for (size_t pos = start_; pos < start_ + quantity; ++pos) {
+      block_traits::construct(alloc_, Touch(pos / kInnerSize) + pos % kInnerSize, element);
+      ++finish_;
     }
-    for (size_t i = start_; i <= finish_; ++i) {
-      buffer[i / kInnerSize][i % kInnerSize].~T();
-    }
-    for (size_t i = 0; i < outer_size_; ++i) {
-      delete[] reinterpret_cast<char*>(buffer[i]);
-    }
-    delete[] buffer;
-    start_ = other.start_;
-    finish_ = other.finish_;
-    outer_size_ = other.outer_size_;
   } catch (...) {
-    size_t saved = finish_;
-    finish_ = pos - 1;
     Delete();
-    finish_ = saved;
-    outer_ = buffer;
     throw;
   }
+}
+
+template<typename T, size_t InnerSize, typename Allocator>
+Deque<T, InnerSize, Allocator>& Deque<T, InnerSize, Allocator>::operator=(const Deque& other) {
+  if (this != &other) {
+    if constexpr (block_traits::propagate_on_container_copy_assignment::value) {
+      Deque copy(other, Allocator(other.alloc_));
+      Swap(copy);
+    } else {
+      Deque copy(other, Allocator(alloc_));
+      Swap(copy);
+    }
+  }
   return *this;
 }
 
-template<typename T>
-size_t Deque<T>::size() const { return finish_ - start_ + 1; }
+/// Without propagation, a Deque can only steal memory from an equal allocator; otherwise the
+/// elements are moved one by one into memory of its own.
+template<typename T, size_t InnerSize, typename Allocator>
+Deque<T, InnerSize, Allocator>& Deque<T, InnerSize, Allocator>::operator=(Deque&& other) noexcept(
+    block_traits::propagate_on_container_move_assignment::value || block_traits::is_always_equal::value) {
+  if (this == &other) {
+    return *this;
+  }
+  if constexpr (!block_traits::propagate_on_container_move_assignment::value) {
+    if (alloc_ != other.alloc_) {
+      assign(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+      return *this;
+    }
+    Deque buffer(get_allocator());
+    buffer.outer_size_ = other.outer_size_;
+    buffer.outer_ = other.outer_;
+    buffer.start_ = other.start_;
+    buffer.finish_ = other.finish_;
+    buffer.blocks_ = other.blocks_;
+    buffer.spare_limit_ = other.spare_limit_;
+    other.outer_size_ = 0;
+    other.outer_ = nullptr;
+    other.start_ = 0;
+    other.finish_ = other.start_ - 1;
+    other.blocks_ = 0;
+    Swap(buffer);
+  } else {
+    Deque buffer(std::move(other));
+    Swap(buffer);
+  }
+  return *this;
+}
 
-template<typename T>
-void Deque<T>::push_back(const T& value) {
+template<typename T, size_t InnerSize, typename Allocator>
+Allocator Deque<T, InnerSize, Allocator>::get_allocator() const { return Allocator(alloc_); }
+
+template<typename T, size_t InnerSize, typename Allocator>
+size_t Deque<T, InnerSize, Allocator>::size() const { return finish_ - start_ + 1; }
+
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::push_back(const T& value) { emplace_back(value); }
+
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::push_back(T&& value) { emplace_back(std::move(value)); }
+
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::push_front(const T& value) { emplace_front(value); }
+
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::push_front(T&& value) { emplace_front(std::move(value)); }
+
+template<typename T, size_t InnerSize, typename Allocator>
+template<typename... Args>
+T& Deque<T, InnerSize, Allocator>::emplace_back(Args&&... args) {
   if (finish_ == outer_size_ * kInnerSize - 1) {
-    Expand();
-  }
-  try {
-    ++finish_;
-    new(outer_[finish_ / kInnerSize] + finish_ % kInnerSize) T(value);
-  } catch (...) {
-    --finish_;
-    throw;
+    MakeRoom(1);
   }
+  size_t pos = finish_ + 1;
+  T* place = Touch(pos >> kShift) + (pos & kMask);
+  block_traits::construct(alloc_, place, std::forward<Args>(args)...);
+  ++finish_;
+  return *place;
 }
 
-template<typename T>
-void Deque<T>::push_front(const T& value) {
+template<typename T, size_t InnerSize, typename Allocator>
+template<typename... Args>
+T& Deque<T, InnerSize, Allocator>::emplace_front(Args&&... args) {
   if (start_ == 0) {
-    Expand();
-  }
-  try {
-    --start_;
-    new(outer_[start_ / kInnerSize] + start_ % kInnerSize) T(value);
-  } catch (...) {
-    ++start_;
-    throw;
+    MakeRoom(1);
   }
+  size_t pos = start_ - 1;
+  T* place = Touch(pos >> kShift) + (pos & kMask);
+  block_traits::construct(alloc_, place, std::forward<Args>(args)...);
+  --start_;
+  return *place;
 }
 
-template<typename T>
-void Deque<T>::pop_back() {
-  outer_[finish_ / kInnerSize][finish_ % kInnerSize].~T();
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::pop_back() {
+  block_traits::destroy(alloc_, outer_[finish_ >> kShift] + (finish_ & kMask));
   --finish_;
+  if (((finish_ + 1) & kMask) == 0) {
+    Release((finish_ + 1) >> kShift);
+  }
 }
 
-template<typename T>
-void Deque<T>::pop_front() {
-  outer_[start_ / kInnerSize][start_ % kInnerSize].~T();
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::pop_front() {
+  block_traits::destroy(alloc_, outer_[start_ >> kShift] + (start_ & kMask));
   ++start_;
+  if ((start_ & kMask) == 0) {
+    Release((start_ - 1) >> kShift);
+  }
 }
 
-template<typename T>
-T& Deque<T>::operator[](size_t pos) {
+template<typename T, size_t InnerSize, typename Allocator>
+T& Deque<T, InnerSize, Allocator>::operator[](size_t pos) {
   pos += start_;
-  return outer_[pos / kInnerSize][pos % kInnerSize];
+  return outer_[pos >> kShift][pos & kMask];
 }
 
-template<typename T>
-const T& Deque<T>::operator[](size_t pos) const {
+template<typename T, size_t InnerSize, typename Allocator>
+const T& Deque<T, InnerSize, Allocator>::operator[](size_t pos) const {
   pos += start_;
-  return outer_[pos / kInnerSize][pos % kInnerSize];
+  return outer_[pos >> kShift][pos & kMask];
 }
 
-template<typename T>
-T& Deque<T>::at(size_t pos) {
-  if (pos < 0 or pos >= size()) {
+template<typename T, size_t InnerSize, typename Allocator>
+T& Deque<T, InnerSize, Allocator>::at(size_t pos) {
+  if (pos >= size()) {
     throw std::out_of_range("Deque index out of range");
   }
   pos += start_;
-  return outer_[pos / kInnerSize][pos % kInnerSize];
+  return outer_[pos >> kShift][pos & kMask];
 }
 
-template<typename T>
-const T& Deque<T>::at(size_t pos) const {
-  if (pos < start_ or pos >= finish_) {
+template<typename T, size_t InnerSize, typename Allocator>
+const T& Deque<T, InnerSize, Allocator>::at(size_t pos) const {
+  if (pos >= size()) {
     throw std::out_of_range("Deque index out of range");
   }
   pos += start_;
-  return outer_[pos / kInnerSize][pos % kInnerSize];
+  return outer_[pos >> kShift][pos & kMask];
 }
 
-template<typename T>
-DequeIterator<T> Deque<T>::begin() { return DequeIterator<T>(start_, outer_ + (start_ / kInnerSize), false); }
+template<typename T, size_t InnerSize, typename Allocator>
+DequeIterator<T, InnerSize> Deque<T, InnerSize, Allocator>::begin() { return DequeIterator<T, InnerSize>(start_, BlockOf(start_), false); }
 
-template<typename T>
-DequeIterator<T> Deque<T>::end() { return DequeIterator<T>((finish_ + 1), outer_ + ((finish_ + 1) / kInnerSize), false); }
+template<typename T, size_t InnerSize, typename Allocator>
+DequeIterator<T, InnerSize> Deque<T, InnerSize, Allocator>::end() { return DequeIterator<T, InnerSize>((finish_ + 1), BlockOf(finish_ + 1), false); }
 
-template<typename T>
-DequeIterator<const T> Deque<T>::begin() const {
+template<typename T, size_t InnerSize, typename Allocator>
+DequeIterator<const T, InnerSize> Deque<T, InnerSize, Allocator>::begin() const {
   return cbegin();
 }
 
-template<typename T>
-DequeIterator<const T> Deque<T>::end() const {
+template<typename T, size_t InnerSize, typename Allocator>
+DequeIterator<const T, InnerSize> Deque<T, InnerSize, Allocator>::end() const {
   return cend();
 }
 
-template<typename T>
-DequeIterator<const T> Deque<T>::cbegin() const {
-  return DequeIterator<const T>(start_, const_cast<const T**>(outer_ + (start_ / kInnerSize)), false);
+template<typename T, size_t InnerSize, typename Allocator>
+DequeIterator<const T, InnerSize> Deque<T, InnerSize, Allocator>::cbegin() const {
+  return DequeIterator<const T, InnerSize>(start_, const_cast<const T**>(BlockOf(start_)), false);
 }
 
-template<typename T>
-DequeIterator<const T> Deque<T>::cend() const {
-  return DequeIterator<const T>((finish_ + 1), const_cast<const T**>(outer_ + ((finish_ + 1) / kInnerSize)), false);
+template<typename T, size_t InnerSize, typename Allocator>
+DequeIterator<const T, InnerSize> Deque<T, InnerSize, Allocator>::cend() const {
+  return DequeIterator<const T, InnerSize>((finish_ + 1), const_cast<const T**>(BlockOf(finish_ + 1)), false);
 }
 
-template<typename T>
-DequeIterator<T> Deque<T>::rbegin() { return DequeIterator<T>(finish_, outer_ + (finish_ / kInnerSize), true); }
+template<typename T, size_t InnerSize, typename Allocator>
+DequeIterator<T, InnerSize> Deque<T, InnerSize, Allocator>::rbegin() { return DequeIterator<T, InnerSize>(finish_, BlockOf(finish_), true); }
 
-template<typename T>
-DequeIterator<T> Deque<T>::rend() { return DequeIterator<T>((start_ - 1), outer_ + ((start_ - 1) / kInnerSize), true); }
+template<typename T, size_t InnerSize, typename Allocator>
+DequeIterator<T, InnerSize> Deque<T, InnerSize, Allocator>::rend() { return DequeIterator<T, InnerSize>((start_ - 1), BlockOf(start_ - 1), true); }
 
-template<typename T>
-DequeIterator<const T> Deque<T>::rbegin() const {
+template<typename T, size_t InnerSize, typename Allocator>
+DequeIterator<const T, InnerSize> Deque<T, InnerSize, Allocator>::rbegin() const {
   return crbegin();
 }
 
-template<typename T>
-DequeIterator<const T> Deque<T>::rend() const {
+template<typename T, size_t InnerSize, typename Allocator>
+DequeIterator<const T, InnerSize> Deque<T, InnerSize, Allocator>::rend() const {
   return crend();
 }
 
-template<typename T>
-DequeIterator<const T> Deque<T>::crbegin() const {
-  return DequeIterator<const T>(finish_, const_cast<const T**>(outer_ + (finish_ / kInnerSize), true));
+template<typename T, size_t InnerSize, typename Allocator>
+DequeIterator<const T, InnerSize> Deque<T, InnerSize, Allocator>::crbegin() const {
+  return DequeIterator<const T, InnerSize>(finish_, const_cast<const T**>(BlockOf(finish_)), true);
 }
 
-template<typename T>
-DequeIterator<const T> Deque<T>::crend() const {
-  return DequeIterator<const T>((start_ - 1), const_cast<const T**>(outer_ + ((start_ - 1) / kInnerSize)), true);
+template<typename T, size_t InnerSize, typename Allocator>
+DequeIterator<const T, InnerSize> Deque<T, InnerSize, Allocator>::crend() const {
+  return DequeIterator<const T, InnerSize>((start_ - 1), const_cast<const T**>(BlockOf(start_ - 1)), true);
 }
 
-template<typename T>
-void Deque<T>::insert(const DequeIterator<T>& it, const T& elem) {
-  if (it == end()) {
-    push_back(elem);
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::insert(const DequeIterator<T, InnerSize>& it, const T& elem) { emplace(it, elem); }
+
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::insert(const DequeIterator<T, InnerSize>& it, T&& elem) { emplace(it, std::move(elem)); }
+
+template<typename T, size_t InnerSize, typename Allocator>
+template<typename... Args>
+void Deque<T, InnerSize, Allocator>::emplace(const DequeIterator<T, InnerSize>& it, Args&&... args) {
+  size_t index = it.position_ - start_;
+  if (index == size()) {
+    emplace_back(std::forward<Args>(args)...);
     return;
   }
-  auto x = *rbegin();
-  push_back(x);
-  DequeIterator forward = --(--end());
-  DequeIterator backward = --end();
-  while (backward != it) {
-    *backward = *forward;
-    --backward;
-    --forward;
+  T value(std::forward<Args>(args)...);
+  if constexpr (kMoveOnRelocate) {
+    emplace_back(std::move((*this)[size() - 1]));
+  } else {
+    emplace_back((*this)[size() - 1]);
+  }
+  for (size_t i = size() - 2; i > index; --i) {
+    Relocate((*this)[i], (*this)[i - 1]);
   }
-  *backward = elem;
+  Relocate((*this)[index], value);
 }
 
-template<typename T>
-void Deque<T>::erase(const DequeIterator<T>& it) {
-  DequeIterator forward = DequeIterator(it.position_, it.outer_pointer_, false);
-  forward.is_reverse_ = false;
-  DequeIterator backward = forward;
-  ++forward;
-  DequeIterator stop = end();
-  while (forward != stop) {
-    *backward = *forward;
-    ++backward;
-    ++forward;
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::erase(const DequeIterator<T, InnerSize>& it) {
+  for (size_t i = it.position_ - start_; i + 1 < size(); ++i) {
+    Relocate((*this)[i], (*this)[i + 1]);
   }
   pop_back();
 }
 
-template<typename T>
-Deque<T>::~Deque() { Delete(); }
+/// Opens the gap on whichever side of `it` is shorter. Trivially copyable elements are shifted
+/// with one memmove per block; anything else is constructed at the end and rotated into place.
+/// Single-pass input is buffered first, since the count has to be known up front.
+template<typename T, size_t InnerSize, typename Allocator>
+template<typename InputIt, typename>
+void Deque<T, InnerSize, Allocator>::insert(const DequeIterator<T, InnerSize>& it, InputIt first, InputIt last) {
+  using Category = typename std::iterator_traits<InputIt>::iterator_category;
+  if constexpr (!std::is_base_of<std::forward_iterator_tag, Category>::value) {
+    Deque buffer(get_allocator());
+    buffer.append(first, last);
+    insert(it, std::make_move_iterator(buffer.begin()), std::make_move_iterator(buffer.end()));
+  } else {
+    size_t index = it.position_ - start_;
+    size_t count = std::distance(first, last);
+    size_t old_size = size();
+    if (count == 0) {
+      return;
+    }
+    if (index >= old_size - index) {
+      if constexpr (kMemmovable) {
+        ReserveBack(count);
+        MoveRange(start_ + index + count, start_ + index, old_size - index);
+        CopyIn(start_ + index, first, count);
+        finish_ += count;
+      } else {
+        append(first, last);
+        std::rotate(begin() + index, begin() + old_size, end());
+      }
+    } else {
+      ReserveFront(count);
+      if constexpr (kMemmovable) {
+        MoveRange(start_ - count, start_, index);
+        CopyIn(start_ - count + index, first, count);
+        start_ -= count;
+      } else {
+        size_t built = 0;
+        try {
+          for (; first != last; ++first, ++built) {
+            size_t pos = start_ - count + built;
+            block_traits::construct(alloc_, outer_[pos / kInnerSize] + pos % kInnerSize, *first);
+          }
+        } catch (...) {
+          for (size_t i = 0; i < built; ++i) {
+            size_t pos = start_ - count + i;
+            block_traits::destroy(alloc_, outer_[pos / kInnerSize] + pos % kInnerSize);
+          }
+          throw;
+        }
+        start_ -= count;
+        std::rotate(begin(), begin() + count, begin() + (count + index));
+      }
+    }
+  }
+}
+
+/// Relocates whichever side of the gap is shorter, then drops the vacated end.
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::erase(const DequeIterator<T, InnerSize>& first, const DequeIterator<T, InnerSize>& last) {
+  size_t from = first.position_ - start_;
+  size_t to = last.position_ - start_;
+  size_t count = to - from;
+  if (count == 0) {
+    return;
+  }
+  if (from < size() - to) {
+    if constexpr (kMemmovable) {
+      MoveRange(start_ + count, start_, from);
+    } else {
+      for (size_t i = from; i > 0; --i) {
+        Relocate((*this)[i - 1 + count], (*this)[i - 1]);
+      }
+    }
+    DropFront(count);
+  } else {
+    if constexpr (kMemmovable) {
+      MoveRange(start_ + from, start_ + to, size() - to);
+    } else {
+      for (size_t i = to; i < size(); ++i) {
+        Relocate((*this)[i - count], (*this)[i]);
+      }
+    }
+    DropBack(count);
+  }
+}
+
+template<typename T, size_t InnerSize, typename Allocator>
+template<typename InputIt, typename>
+void Deque<T, InnerSize, Allocator>::append(InputIt first, InputIt last) {
+  using Category = typename std::iterator_traits<InputIt>::iterator_category;
+  if constexpr (std::is_base_of<std::forward_iterator_tag, Category>::value) {
+    size_t count = std::distance(first, last);
+    ReserveBack(count);
+    if constexpr (kMemmovable) {
+      CopyIn(finish_ + 1, first, count);
+      finish_ += count;
+      return;
+    }
+  }
+  size_t old_size = size();
+  try {
+    for (; first != last; ++first) {
+      emplace_back(*first);
+    }
+  } catch (...) {
+    while (size() > old_size) {
+      pop_back();
+    }
+    throw;
+  }
+}
+
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::append(std::span<const T> items) { append(items.begin(), items.end()); }
+
+template<typename T, size_t InnerSize, typename Allocator>
+template<typename InputIt, typename>
+void Deque<T, InnerSize, Allocator>::prepend(InputIt first, InputIt last) {
+  insert(begin(), first, last);
+}
+
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::prepend(std::span<const T> items) { prepend(items.begin(), items.end()); }
+
+template<typename T, size_t InnerSize, typename Allocator>
+template<typename InputIt, typename>
+void Deque<T, InnerSize, Allocator>::assign(InputIt first, InputIt last) {
+  Deque buffer(get_allocator());
+  buffer.append(first, last);
+  Swap(buffer);
+}
+
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::assign(size_t count, const T& value) {
+  Deque buffer(get_allocator());
+  buffer.GrowBack(count, value);
+  Swap(buffer);
+}
+
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::resize(size_t count) {
+  while (size() > count) {
+    pop_back();
+  }
+  GrowBack(count - size());
+}
+
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::resize(size_t count, const T& value) {
+  while (size() > count) {
+    pop_back();
+  }
+  GrowBack(count - size(), value);
+}
+
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::shrink_to_fit() {
+  if (outer_ == nullptr) {
+    return;
+  }
+  if (finish_ + 1 == start_) {
+    Delete();
+    outer_size_ = 0;
+    outer_ = nullptr;
+    start_ = 0;
+    finish_ = start_ - 1;
+    blocks_ = 0;
+    return;
+  }
+  size_t first = start_ >> kShift;
+  size_t live = LiveBlocks();
+  for (size_t i = 0; i < outer_size_; ++i) {
+    if ((i < first || i >= first + live) && outer_[i] != nullptr) {
+      block_traits::deallocate(alloc_, outer_[i], kInnerSize);
+      outer_[i] = nullptr;
+    }
+  }
+  blocks_ = live;
+  size_t new_size = live < kDefaultOuterSize ? kDefaultOuterSize : live;
+  if (new_size < outer_size_) {
+    T** destination = NewMap(new_size);
+    std::copy_n(outer_ + first, live, destination);
+    start_ -= first * kInnerSize;
+    finish_ -= first * kInnerSize;
+    DeleteMap(outer_, outer_size_);
+    outer_ = destination;
+    outer_size_ = new_size;
+  }
+}
+
+template<typename T, size_t InnerSize, typename Allocator>
+void Deque<T, InnerSize, Allocator>::set_spare_block_limit(size_t blocks) { spare_limit_ = blocks; }
+
+template<typename T, size_t InnerSize, typename Allocator>
+size_t Deque<T, InnerSize, Allocator>::memory_usage() const {
+  size_t map_bytes = outer_ == nullptr ? 0 : (outer_size_ + 2) * sizeof(T*);
+  return blocks_ * kInnerSize * sizeof(T) + map_bytes;
+}
+
+template<typename T, size_t InnerSize, typename Allocator>
+template<typename F>
+void Deque<T, InnerSize, Allocator>::for_each_segment(F f) { ::for_each_segment(begin(), end(), f); }
+
+template<typename T, size_t InnerSize, typename Allocator>
+template<typename F>
+void Deque<T, InnerSize, Allocator>::for_each_segment(F f) const { ::for_each_segment(cbegin(), cend(), f); }
+
+template<typename T, size_t InnerSize, typename Allocator>
+Deque<T, InnerSize, Allocator>::~Deque() { Delete(); }
 
 
 /// ########################################################################################
@@ -467,25 +1095,44 @@ Deque<T>::~Deque() { Delete(); }
 /// ########################################################################################
 
 
-template<typename T>
-void DequeIterator<T>::Increase() {
-  if (position_ % Deque<T>::kInnerSize == Deque<T>::kInnerSize - 1) {
+template<typename T, size_t InnerSize>
+void DequeIterator<T, InnerSize>::Increase() {
+  ++position_;
+  if ((position_ & kMask) == 0) {
     ++outer_pointer_;
+    current_ = *outer_pointer_;
+  } else {
+    ++current_;
   }
-  ++position_;
 }
 
-template<typename T>
-void DequeIterator<T>::Decrease() {
-  if (position_ % Deque<T>::kInnerSize == 0) {
+template<typename T, size_t InnerSize>
+void DequeIterator<T, InnerSize>::Decrease() {
+  if ((position_ & kMask) == 0) {
     --outer_pointer_;
+    current_ = Locate(outer_pointer_, kMask);
+  } else {
+    --current_;
   }
   --position_;
 }
 
+/// Blocks are allocated lazily, so the block an end() iterator lands in may not exist yet.
+template<typename T, size_t InnerSize>
+T* DequeIterator<T, InnerSize>::Locate(T** outer, size_t pos) {
+  return outer == nullptr || *outer == nullptr ? nullptr : *outer + (pos & kMask);
+}
 
-template<typename T>
-int DequeIterator<T>::Subtract(const DequeIterator& other) const {
+template<typename T, size_t InnerSize>
+void DequeIterator<T, InnerSize>::Seek(size_t pos) {
+  outer_pointer_ += (static_cast<ptrdiff_t>(pos) >> kShift) - (static_cast<ptrdiff_t>(position_) >> kShift);
+  position_ = pos;
+  current_ = Locate(outer_pointer_, pos);
+}
+
+
+template<typename T, size_t InnerSize>
+int DequeIterator<T, InnerSize>::Subtract(const DequeIterator& other) const {
   int buff = position_ - other.position_;
   if (is_reverse_) {
     buff *= -1;
@@ -493,11 +1140,11 @@ int DequeIterator<T>::Subtract(const DequeIterator& other) const {
   return buff;
 }
 
-template<typename T>
-DequeIterator<T>::DequeIterator(size_t pos, T** outer, bool rev) : position_(pos), outer_pointer_(outer), is_reverse_(rev) {}
+template<typename T, size_t InnerSize>
+DequeIterator<T, InnerSize>::DequeIterator(size_t pos, T** outer, bool rev) : current_(Locate(outer, pos)), position_(pos), outer_pointer_(outer), is_reverse_(rev) {}
 
-template<typename T>
-DequeIterator<T>& DequeIterator<T>::operator++() {
+template<typename T, size_t InnerSize>
+DequeIterator<T, InnerSize>& DequeIterator<T, InnerSize>::operator++() {
   if (!is_reverse_) {
     Increase();
   } else {
@@ -506,8 +1153,8 @@ DequeIterator<T>& DequeIterator<T>::operator++() {
   return *this;
 }
 
-template<typename T>
-DequeIterator<T>& DequeIterator<T>::operator--() {
+template<typename T, size_t InnerSize>
+DequeIterator<T, InnerSize>& DequeIterator<T, InnerSize>::operator--() {
   if (!is_reverse_) {
     Decrease();
   } else {
@@ -516,96 +1163,160 @@ DequeIterator<T>& DequeIterator<T>::operator--() {
   return *this;
 }
 
-template<typename T>
-DequeIterator<T> DequeIterator<T>::operator++(int) {
+template<typename T, size_t InnerSize>
+DequeIterator<T, InnerSize> DequeIterator<T, InnerSize>::operator++(int) {
   DequeIterator buff(*this);
   ++(*this);
   return buff;
 }
 
-template<typename T>
-DequeIterator<T> DequeIterator<T>::operator--(int) {
+template<typename T, size_t InnerSize>
+DequeIterator<T, InnerSize> DequeIterator<T, InnerSize>::operator--(int) {
   DequeIterator buff(*this);
   --(*this);
   return buff;
 }
 
-template<typename T>
-DequeIterator<T>& DequeIterator<T>::operator+=(int value) {
+template<typename T, size_t InnerSize>
+DequeIterator<T, InnerSize>& DequeIterator<T, InnerSize>::operator+=(int value) {
   if (value == 0) {
     return *this;
   }
-  if ((value > 0 && !is_reverse_) || (value < 0 && is_reverse_)) {
-    if (value < 0) {
-      value = -value;
-    }
-    outer_pointer_ += value / Deque<T>::kInnerSize;
-    if (value % Deque<T>::kInnerSize + position_ % Deque<T>::kInnerSize >= Deque<T>::kInnerSize) {
-      ++outer_pointer_;
-    }
-    position_ += value;
-  } else {
-    if (value < 0) {
-      value = -value;
-    }
-    outer_pointer_ -= value / Deque<T>::kInnerSize;
-    if (position_ % Deque<T>::kInnerSize - value % Deque<T>::kInnerSize >= Deque<T>::kInnerSize) {
-      --outer_pointer_;
-    }
-    position_ -= value;
-  }
+  Seek(position_ + (is_reverse_ ? -static_cast<ptrdiff_t>(value) : value));
   return *this;
 }
 
-template<typename T>
-DequeIterator<T> DequeIterator<T>::operator-=(int value) { return *this += -value; }
+template<typename T, size_t InnerSize>
+DequeIterator<T, InnerSize> DequeIterator<T, InnerSize>::operator-=(int value) { return *this += -value; }
 
-template<typename T>
-DequeIterator<T> DequeIterator<T>::operator+(int value) const {
+template<typename T, size_t InnerSize>
+DequeIterator<T, InnerSize> DequeIterator<T, InnerSize>::operator+(int value) const {
   DequeIterator buff(*this);
   buff += value;
   return buff;
 }
 
-template<typename T>
-DequeIterator<T> DequeIterator<T>::operator-(int value) const { return *this + -value; }
+template<typename T, size_t InnerSize>
+DequeIterator<T, InnerSize> DequeIterator<T, InnerSize>::operator-(int value) const { return *this + -value; }
 
-template<typename T>
-int DequeIterator<T>::operator-(const DequeIterator& other) const {
+template<typename T, size_t InnerSize>
+int DequeIterator<T, InnerSize>::operator-(const DequeIterator& other) const {
   return Subtract(other);
 }
 
-template<typename T>
-int DequeIterator<T>::operator-(const DequeIterator<const typename std::remove_const<T>>& other) const {
+template<typename T, size_t InnerSize>
+int DequeIterator<T, InnerSize>::operator-(const DequeIterator<const typename std::remove_const<T>>& other) const {
   return Subtract(other);
 }
 
-template<typename T>
-bool operator<(const DequeIterator<T>& first, const DequeIterator<T>& second) { return (first.position_ != second.position_) && (first.position_ < second.position_) ^ (first.is_reverse_); }
-
-template<typename T>
-bool operator==(const DequeIterator<T>& first, const DequeIterator<T>& second) { return !(first < second) && !(second < first); }
-
-template<typename T>
-bool operator!=(const DequeIterator<T>& first, const DequeIterator<T>& second) { return !(first == second); }
-
-template<typename T>
-bool operator>=(const DequeIterator<T>& first, const DequeIterator<T>& second) { return !(first < second); }
-
-template<typename T>
-bool operator>(const DequeIterator<T>& first, const DequeIterator<T>& second) { return (first != second && first >= second); }
+template<typename T, size_t InnerSize>
+bool operator<(const DequeIterator<T, InnerSize>& first, const DequeIterator<T, InnerSize>& second) { return (first.position_ != second.position_) && (first.position_ < second.position_) ^ (first.is_reverse_); }
+
+template<typename T, size_t InnerSize>
+bool operator==(const DequeIterator<T, InnerSize>& first, const DequeIterator<T, InnerSize>& second) { return first.position_ == second.position_; }
+
+template<typename T, size_t InnerSize>
+bool operator!=(const DequeIterator<T, InnerSize>& first, const DequeIterator<T, InnerSize>& second) { return !(first == second); }
+
+template<typename T, size_t InnerSize>
+bool operator>=(const DequeIterator<T, InnerSize>& first, const DequeIterator<T, InnerSize>& second) { return !(first < second); }
+
+template<typename T, size_t InnerSize>
+bool operator>(const DequeIterator<T, InnerSize>& first, const DequeIterator<T, InnerSize>& second) { return (first != second && first >= second); }
+
+template<typename T, size_t InnerSize>
+bool operator<=(const DequeIterator<T, InnerSize>& first, const DequeIterator<T, InnerSize>& second) { return (first == second || first < second); }
+
+template<typename T, size_t InnerSize>
+T& DequeIterator<T, InnerSize>::operator*() const { return *current_; }
+
+template<typename T, size_t InnerSize>
+T* DequeIterator<T, InnerSize>::operator->() const { return current_; }
+
+
+/// #################################################################################
+/// #############################  Segmented Algorithms #############################
+/// #################################################################################
+
+
+/// Calls f(segment_first, segment_last) for each block-contiguous run of [first, last), in
+/// traversal order. f may return bool; returning false stops the walk. Reverse iterators are
+/// walked one element per segment, since their runs are not ascending in memory.
+template<typename T, size_t InnerSize, typename F>
+void for_each_segment(DequeIterator<T, InnerSize> first, DequeIterator<T, InnerSize> last, F f) {
+  size_t remaining = last - first;
+  size_t position = first.position_;
+  T** block = first.outer_pointer_;
+  while (remaining > 0) {
+    T* segment_first;
+    size_t length;
+    if (first.is_reverse_) {
+      segment_first = *block + position % InnerSize;
+      length = 1;
+      if (position % InnerSize == 0) {
+        --block;
+      }
+      --position;
+    } else {
+      size_t offset = position % InnerSize;
+      segment_first = *block + offset;
+      length = std::min(InnerSize - offset, remaining);
+      ++block;
+      position += length;
+    }
+    remaining -= length;
+    if constexpr (std::is_same<decltype(f(segment_first, segment_first)), bool>::value) {
+      if (!f(segment_first, segment_first + length)) {
+        return;
+      }
+    } else {
+      f(segment_first, segment_first + length);
+    }
+  }
+}
 
-template<typename T>
-bool operator<=(const DequeIterator<T>& first, const DequeIterator<T>& second) { return (first == second || first < second); }
+template<typename T, size_t InnerSize, typename OutputIt>
+OutputIt copy(DequeIterator<T, InnerSize> first, DequeIterator<T, InnerSize> last, OutputIt out) {
+  for_each_segment(first, last, [&out](T* segment_first, T* segment_last) { out = std::copy(segment_first, segment_last, out); });
+  return out;
+}
 
-template<typename T>
-T& DequeIterator<T>::operator*() { return (*outer_pointer_)[position_ % Deque<T>::kInnerSize]; }
+template<typename T, size_t InnerSize, typename U>
+void fill(DequeIterator<T, InnerSize> first, DequeIterator<T, InnerSize> last, const U& value) {
+  for_each_segment(first, last, [&value](T* segment_first, T* segment_last) { std::fill(segment_first, segment_last, value); });
+}
 
-template<typename T>
-const T& DequeIterator<T>::operator*() const { return (*outer_pointer_)[position_ % Deque<T>::kInnerSize]; }
+template<typename T, size_t InnerSize, typename U>
+DequeIterator<T, InnerSize> find(DequeIterator<T, InnerSize> first, DequeIterator<T, InnerSize> last, const U& value) {
+  int offset = 0;
+  for_each_segment(first, last, [&offset, &value](T* segment_first, T* segment_last) {
+    T* found = std::find(segment_first, segment_last, value);
+    offset += found - segment_first;
+    return found == segment_last;
+  });
+  return first + offset;
+}
 
-template<typename T>
-T* DequeIterator<T>::operator->() { return &(*outer_pointer_)[position_ % Deque<T>::kInnerSize]; }
+template<typename T, size_t InnerSize, typename U>
+U accumulate(DequeIterator<T, InnerSize> first, DequeIterator<T, InnerSize> last, U init) {
+  for_each_segment(first, last, [&init](T* segment_first, T* segment_last) {
+    init = std::accumulate(segment_first, segment_last, std::move(init));
+  });
+  return init;
+}
 
-template<typename T>
-const T* DequeIterator<T>::operator->() const { return &(*outer_pointer_)[position_ % Deque<T>::kInnerSize]; }
+/// Sorts through a contiguous scratch buffer: one pass out, std::sort on flat memory, one pass back.
+template<typename T, size_t InnerSize, typename Compare = std::less<>>
+void sort(DequeIterator<T, InnerSize> first, DequeIterator<T, InnerSize> last, Compare comp = Compare()) {
+  std::vector<T> buffer;
+  buffer.reserve(last - first);
+  for_each_segment(first, last, [&buffer](T* segment_first, T* segment_last) {
+    buffer.insert(buffer.end(), std::make_move_iterator(segment_first), std::make_move_iterator(segment_last));
+  });
+  std::sort(buffer.begin(), buffer.end(), comp);
+  auto next = buffer.begin();
+  for_each_segment(first, last, [&next](T* segment_first, T* segment_last) {
+    std::move(next, next + (segment_last - segment_first), segment_first);
+    next += segment_last - segment_first;
+  });
+}
@@ -0,0 +1,493 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+#include "deque.hpp"
+
+
+/// ##########################################################################################
+/// #############################  SnapshotDeque Declaration #################################
+/// ##########################################################################################
+
+
+/// Copy-on-write Deque for cheap read-only snapshots. Blocks are reference-counted: copying
+/// shares every live block (O(number of blocks)) and a block is duplicated only when a copy
+/// writes to it. Blocks no longer spanned by a copy's range are released at once, so every
+/// non-null map slot overlaps [start_, finish_].
+///
+/// Reads through a non-const object unshare: take a const reference to read a snapshot.
+/// Copies may be used from different threads; a single copy is not thread-safe.
+template<typename T, size_t InnerSize = DequeBlockSize<T>()>
+class SnapshotDeque {
+public:
+  using const_iterator = DequeIterator<const T, InnerSize>;
+
+  SnapshotDeque();
+
+  SnapshotDeque(const SnapshotDeque& other);
+
+  SnapshotDeque(SnapshotDeque&& other) noexcept;
+
+  SnapshotDeque& operator=(const SnapshotDeque& other);
+
+  SnapshotDeque& operator=(SnapshotDeque&& other) noexcept;
+
+  SnapshotDeque snapshot() const;
+
+  size_t size() const;
+
+  bool empty() const;
+
+  void push_back(const T& value);
+
+  void push_back(T&& value);
+
+  void push_front(const T& value);
+
+  void push_front(T&& value);
+
+  template<typename... Args>
+  T& emplace_back(Args&&... args);
+
+  template<typename... Args>
+  T& emplace_front(Args&&... args);
+
+  void pop_back();
+
+  void pop_front();
+
+  T& operator[](size_t pos);
+
+  const T& operator[](size_t pos) const;
+
+  T& at(size_t pos);
+
+  const T& at(size_t pos) const;
+
+  const_iterator begin() const;
+
+  const_iterator end() const;
+
+  const_iterator cbegin() const;
+
+  const_iterator cend() const;
+
+  /// Live blocks that are currently shared with another copy.
+  size_t shared_blocks() const;
+
+  ~SnapshotDeque();
+
+private:
+  /// Slots [first, last) of `slots` hold constructed elements. A shared block may hold more
+  /// than a given copy can see; the last owner destroys them.
+  struct Block {
+    std::atomic<size_t> refs;
+    size_t first;
+    size_t last;
+    alignas(T) unsigned char slots[sizeof(T) * InnerSize];
+  };
+
+  static Block* HeaderOf(T* slots);
+
+  static T* NewBlock();
+
+  static void Release(T* slots);
+
+  T* Own(size_t block);
+
+  void Trim(size_t block);
+
+  void Leave(size_t block);
+
+  void MakeRoom();
+
+  void Recenter(size_t first, size_t live);
+
+  void Expand();
+
+  void Delete();
+
+  void Swap(SnapshotDeque& other);
+
+  static T** NewMap(size_t size);
+
+  static void DeleteMap(T** map);
+
+  T** BlockOf(size_t pos) const;
+
+  static_assert(std::has_single_bit(InnerSize), "Deque block size must be a power of two");
+
+  static const size_t kInnerSize = InnerSize;
+  static const size_t kShift = std::countr_zero(InnerSize);
+  static const size_t kMask = InnerSize - 1;
+  static const size_t kDefaultOuterSize = 2;
+
+  size_t outer_size_;
+  T** outer_;
+  size_t start_;
+  size_t finish_;
+};
+
+
+/// ##########################################################################################
+/// #############################  SnapshotDeque Realization #################################
+/// ##########################################################################################
+
+
+template<typename T, size_t InnerSize>
+typename SnapshotDeque<T, InnerSize>::Block* SnapshotDeque<T, InnerSize>::HeaderOf(T* slots) {
+  return reinterpret_cast<Block*>(reinterpret_cast<unsigned char*>(slots) - offsetof(Block, slots));
+}
+
+template<typename T, size_t InnerSize>
+T* SnapshotDeque<T, InnerSize>::NewBlock() {
+  Block* block = new Block;
+  block->refs.store(1, std::memory_order_relaxed);
+  block->first = 0;
+  block->last = 0;
+  return reinterpret_cast<T*>(block->slots);
+}
+
+template<typename T, size_t InnerSize>
+void SnapshotDeque<T, InnerSize>::Release(T* slots) {
+  Block* block = HeaderOf(slots);
+  if (block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    for (size_t i = block->first; i < block->last; ++i) {
+      slots[i].~T();
+    }
+    delete block;
+  }
+}
+
+/// Makes `block` writable by this copy alone: duplicates it if shared, otherwise drops the
+/// elements other copies left behind outside this copy's range.
+template<typename T, size_t InnerSize>
+T* SnapshotDeque<T, InnerSize>::Own(size_t block) {
+  T* slots = outer_[block];
+  if (HeaderOf(slots)->refs.load(std::memory_order_acquire) == 1) {
+    Trim(block);
+    return slots;
+  }
+  size_t base = block << kShift;
+  size_t first = (start_ > base ? start_ : base) - base;
+  size_t last = (finish_ + 1 < base + kInnerSize ? finish_ + 1 : base + kInnerSize) - base;
+  T* fresh = NewBlock();
+  Block* header = HeaderOf(fresh);
+  header->first = first;
+  header->last = first;
+  try {
+    for (; header->last < last; ++header->last) {
+      new(fresh + header->last) T(slots[header->last]);
+    }
+  } catch (...) {
+    Release(fresh);
+    throw;
+  }
+  Release(slots);
+  outer_[block] = fresh;
+  return fresh;
+}
+
+template<typename T, size_t InnerSize>
+void SnapshotDeque<T, InnerSize>::Trim(size_t block) {
+  T* slots = outer_[block];
+  Block* header = HeaderOf(slots);
+  size_t base = block << kShift;
+  size_t first = empty() || start_ >= base + kInnerSize ? header->last : (start_ > base ? start_ - base : 0);
+  size_t last = empty() || finish_ < base ? first : (finish_ + 1 < base + kInnerSize ? finish_ + 1 - base : kInnerSize);
+  for (; header->first < first && header->first < header->last; ++header->first) {
+    slots[header->first].~T();
+  }
+  for (; header->last > last && header->last > header->first; --header->last) {
+    slots[header->last - 1].~T();
+  }
+  if (header->first == header->last) {
+    header->first = first;
+    header->last = first;
+  }
+}
+
+/// Called when the range no longer reaches `block`.
+template<typename T, size_t InnerSize>
+void SnapshotDeque<T, InnerSize>::Leave(size_t block) {
+  if (outer_[block] != nullptr) {
+    Release(outer_[block]);
+    outer_[block] = nullptr;
+  }
+}
+
+template<typename T, size_t InnerSize>
+void SnapshotDeque<T, InnerSize>::MakeRoom() {
+  size_t first = start_ >> kShift;
+  size_t live = ((finish_ + kInnerSize) >> kShift) - first;
+  if (outer_size_ != 0 && 2 * (live + 1) <= outer_size_) {
+    Recenter(first, live);
+  } else {
+    Expand();
+  }
+}
+
+template<typename T, size_t InnerSize>
+void SnapshotDeque<T, InnerSize>::Recenter(size_t first, size_t live) {
+  size_t target = (outer_size_ - live) / 2;
+  if (target < first) {
+    std::rotate(outer_, outer_ + (first - target), outer_ + outer_size_);
+    start_ -= (first - target) * kInnerSize;
+    finish_ -= (first - target) * kInnerSize;
+  } else {
+    std::rotate(outer_, outer_ + outer_size_ - (target - first), outer_ + outer_size_);
+    start_ += (target - first) * kInnerSize;
+    finish_ += (target - first) * kInnerSize;
+  }
+}
+
+template<typename T, size_t InnerSize>
+void SnapshotDeque<T, InnerSize>::Expand() {
+  size_t new_size = outer_size_ == 0 ? kDefaultOuterSize : outer_size_ * 2;
+  T** destination = NewMap(new_size);
+  size_t shift = (new_size - outer_size_) / 2;
+  for (size_t i = 0; i < outer_size_; ++i) {
+    destination[i + shift] = outer_[i];
+  }
+  start_ += shift * kInnerSize;
+  finish_ += shift * kInnerSize;
+  DeleteMap(outer_);
+  outer_ = destination;
+  outer_size_ = new_size;
+}
+
+template<typename T, size_t InnerSize>
+void SnapshotDeque<T, InnerSize>::Delete() {
+  for (size_t i = 0; i < outer_size_; ++i) {
+    if (outer_[i] != nullptr) {
+      Release(outer_[i]);
+    }
+  }
+  DeleteMap(outer_);
+}
+
+template<typename T, size_t InnerSize>
+void SnapshotDeque<T, InnerSize>::Swap(SnapshotDeque& other) {
+  std::swap(outer_size_, other.outer_size_);
+  std::swap(outer_, other.outer_);
+  std::swap(start_, other.start_);
+  std::swap(finish_, other.finish_);
+}
+
+template<typename T, size_t InnerSize>
+T** SnapshotDeque<T, InnerSize>::NewMap(size_t size) { return new T*[size + 2]() + 1; }
+
+template<typename T, size_t InnerSize>
+void SnapshotDeque<T, InnerSize>::DeleteMap(T** map) {
+  if (map != nullptr) {
+    delete[] (map - 1);
+  }
+}
+
+template<typename T, size_t InnerSize>
+T** SnapshotDeque<T, InnerSize>::BlockOf(size_t pos) const {
+  return outer_ == nullptr ? nullptr : outer_ + (static_cast<ptrdiff_t>(pos) >> kShift);
+}
+
+
+template<typename T, size_t InnerSize>
+SnapshotDeque<T, InnerSize>::SnapshotDeque() : outer_size_(0), outer_(nullptr), start_(0), finish_(start_ - 1) {}
+
+/// Shares every live block; no element is copied.
+template<typename T, size_t InnerSize>
+SnapshotDeque<T, InnerSize>::SnapshotDeque(const SnapshotDeque& other)
+    : outer_size_(other.outer_size_), outer_(other.outer_ == nullptr ? nullptr : NewMap(outer_size_)),
+      start_(other.start_), finish_(other.finish_) {
+  for (size_t i = 0; i < outer_size_; ++i) {
+    if (other.outer_[i] != nullptr) {
+      HeaderOf(other.outer_[i])->refs.fetch_add(1, std::memory_order_relaxed);
+      outer_[i] = other.outer_[i];
+    }
+  }
+}
+
+template<typename T, size_t InnerSize>
+SnapshotDeque<T, InnerSize>::SnapshotDeque(SnapshotDeque&& other) noexcept
+    : outer_size_(other.outer_size_), outer_(other.outer_), start_(other.start_), finish_(other.finish_) {
+  other.outer_size_ = 0;
+  other.outer_ = nullptr;
+  other.start_ = 0;
+  other.finish_ = other.start_ - 1;
+}
+
+template<typename T, size_t InnerSize>
+SnapshotDeque<T, InnerSize>& SnapshotDeque<T, InnerSize>::operator=(const SnapshotDeque& other) {
+  if (this != &other) {
+    SnapshotDeque copy(other);
+    Swap(copy);
+  }
+  return *this;
+}
+
+template<typename T, size_t InnerSize>
+SnapshotDeque<T, InnerSize>& SnapshotDeque<T, InnerSize>::operator=(SnapshotDeque&& other) noexcept {
+  if (this != &other) {
+    SnapshotDeque buffer(std::move(other));
+    Swap(buffer);
+  }
+  return *this;
+}
+
+template<typename T, size_t InnerSize>
+SnapshotDeque<T, InnerSize> SnapshotDeque<T, InnerSize>::snapshot() const { return *this; }
+
+template<typename T, size_t InnerSize>
+size_t SnapshotDeque<T, InnerSize>::size() const { return finish_ - start_ + 1; }
+
+template<typename T, size_t InnerSize>
+bool SnapshotDeque<T, InnerSize>::empty() const { return finish_ + 1 == start_; }
+
+template<typename T, size_t InnerSize>
+void SnapshotDeque<T, InnerSize>::push_back(const T& value) { emplace_back(value); }
+
+template<typename T, size_t InnerSize>
+void SnapshotDeque<T, InnerSize>::push_back(T&& value) { emplace_back(std::move(value)); }
+
+template<typename T, size_t InnerSize>
+void SnapshotDeque<T, InnerSize>::push_front(const T& value) { emplace_front(value); }
+
+template<typename T, size_t InnerSize>
+void SnapshotDeque<T, InnerSize>::push_front(T&& value) { emplace_front(std::move(value)); }
+
+template<typename T, size_t InnerSize>
+template<typename... Args>
+T& SnapshotDeque<T, InnerSize>::emplace_back(Args&&... args) {
+  if (finish_ == outer_size_ * kInnerSize - 1) {
+    MakeRoom();
+  }
+  size_t pos = finish_ + 1;
+  size_t block = pos >> kShift;
+  bool fresh = outer_[block] == nullptr;
+  T* slots = fresh ? (outer_[block] = NewBlock()) : Own(block);
+  Block* header = HeaderOf(slots);
+  try {
+    new(slots + (pos & kMask)) T(std::forward<Args>(args)...);
+  } catch (...) {
+    if (fresh) {
+      Leave(block);
+    }
+    throw;
+  }
+  if (header->first == header->last) {
+    header->first = pos & kMask;
+  }
+  header->last = (pos & kMask) + 1;
+  ++finish_;
+  return slots[pos & kMask];
+}
+
+template<typename T, size_t InnerSize>
+template<typename... Args>
+T& SnapshotDeque<T, InnerSize>::emplace_front(Args&&... args) {
+  if (start_ == 0) {
+    MakeRoom();
+  }
+  size_t pos = start_ - 1;
+  size_t block = pos >> kShift;
+  bool fresh = outer_[block] == nullptr;
+  T* slots = fresh ? (outer_[block] = NewBlock()) : Own(block);
+  Block* header = HeaderOf(slots);
+  try {
+    new(slots + (pos & kMask)) T(std::forward<Args>(args)...);
+  } catch (...) {
+    if (fresh) {
+      Leave(block);
+    }
+    throw;
+  }
+  if (header->first == header->last) {
+    header->last = (pos & kMask) + 1;
+  }
+  header->first = pos & kMask;
+  --start_;
+  return slots[pos & kMask];
+}
+
+/// A shared block is left untouched: the element stays alive for the copies that still see it.
+template<typename T, size_t InnerSize>
+void SnapshotDeque<T, InnerSize>::pop_back() {
+  size_t block = finish_ >> kShift;
+  --finish_;
+  if (empty() || ((finish_ + 1) & kMask) == 0) {
+    Leave(block);
+  } else if (HeaderOf(outer_[block])->refs.load(std::memory_order_acquire) == 1) {
+    Trim(block);
+  }
+}
+
+template<typename T, size_t InnerSize>
+void SnapshotDeque<T, InnerSize>::pop_front() {
+  size_t block = start_ >> kShift;
+  ++start_;
+  if (empty() || (start_ & kMask) == 0) {
+    Leave(block);
+  } else if (HeaderOf(outer_[block])->refs.load(std::memory_order_acquire) == 1) {
+    Trim(block);
+  }
+}
+
+template<typename T, size_t InnerSize>
+T& SnapshotDeque<T, InnerSize>::operator[](size_t pos) {
+  pos += start_;
+  return Own(pos >> kShift)[pos & kMask];
+}
+
+template<typename T, size_t InnerSize>
+const T& SnapshotDeque<T, InnerSize>::operator[](size_t pos) const {
+  pos += start_;
+  return outer_[pos >> kShift][pos & kMask];
+}
+
+template<typename T, size_t InnerSize>
+T& SnapshotDeque<T, InnerSize>::at(size_t pos) {
+  if (pos >= size()) {
+    throw std::out_of_range("SnapshotDeque index out of range");
+  }
+  return (*this)[pos];
+}
+
+template<typename T, size_t InnerSize>
+const T& SnapshotDeque<T, InnerSize>::at(size_t pos) const {
+  if (pos >= size()) {
+    throw std::out_of_range("SnapshotDeque index out of range");
+  }
+  return (*this)[pos];
+}
+
+template<typename T, size_t InnerSize>
+typename SnapshotDeque<T, InnerSize>::const_iterator SnapshotDeque<T, InnerSize>::begin() const { return cbegin(); }
+
+template<typename T, size_t InnerSize>
+typename SnapshotDeque<T, InnerSize>::const_iterator SnapshotDeque<T, InnerSize>::end() const { return cend(); }
+
+template<typename T, size_t InnerSize>
+typename SnapshotDeque<T, InnerSize>::const_iterator SnapshotDeque<T, InnerSize>::cbegin() const {
+  return const_iterator(start_, const_cast<const T**>(BlockOf(start_)), false);
+}
+
+template<typename T, size_t InnerSize>
+typename SnapshotDeque<T, InnerSize>::const_iterator SnapshotDeque<T, InnerSize>::cend() const {
+  return const_iterator(finish_ + 1, const_cast<const T**>(BlockOf(finish_ + 1)), false);
+}
+
+template<typename T, size_t InnerSize>
+size_t SnapshotDeque<T, InnerSize>::shared_blocks() const {
+  size_t count = 0;
+  for (size_t i = 0; i < outer_size_; ++i) {
+    if (outer_[i] != nullptr && HeaderOf(outer_[i])->refs.load(std::memory_order_relaxed) > 1) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+template<typename T, size_t InnerSize>
+SnapshotDeque<T, InnerSize>::~SnapshotDeque() { Delete(); }
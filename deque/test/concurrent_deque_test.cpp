@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_deque.hpp"
+
+// The multi-threaded cases are meant to run under ThreadSanitizer as well
+// (the ThreadSanitized preset, or -DUSE_THREAD_SANITIZER=ON).
+
+TEST(spsc_deque, single_thread_fifo) {
+  SpscDeque<int, 4> queue;
+  int out = 0;
+  EXPECT_FALSE(queue.try_pop_front(out));
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 11; ++i) {
+      queue.push_back(i);
+    }
+    for (int i = 0; i < 11; ++i) {
+      ASSERT_TRUE(queue.try_pop_front(out));
+      EXPECT_EQ(out, i);
+    }
+    EXPECT_FALSE(queue.try_pop_front(out));
+  }
+}
+
+TEST(spsc_deque, destroys_unconsumed_elements) {
+  auto tracker = std::make_shared<int>(0);
+  {
+    SpscDeque<std::shared_ptr<int>, 4> queue;
+    for (int i = 0; i < 10; ++i) {
+      queue.push_back(tracker);
+    }
+    std::shared_ptr<int> out;
+    queue.try_pop_front(out);
+    queue.try_pop_front(out);
+    EXPECT_EQ(tracker.use_count(), 10);
+  }
+  EXPECT_EQ(tracker.use_count(), 1);
+}
+
+TEST(spsc_deque, stress_producer_consumer_order) {
+  const int count = 1'000'000;
+  SpscDeque<int, 16> queue;
+  std::thread producer([&queue] {
+    for (int i = 0; i < count; ++i) {
+      queue.push_back(i);
+    }
+  });
+  int expected = 0;
+  int out = 0;
+  while (expected < count) {
+    if (queue.try_pop_front(out)) {
+      ASSERT_EQ(out, expected);
+      ++expected;
+    }
+  }
+  producer.join();
+  EXPECT_FALSE(queue.try_pop_front(out));
+}
+
+TEST(spsc_deque, stress_non_trivial_elements) {
+  const int count = 200'000;
+  SpscDeque<std::string, 8> queue;
+  std::thread producer([&queue] {
+    for (int i = 0; i < count; ++i) {
+      queue.emplace_back(std::to_string(i) + std::string(20, 'x'));
+    }
+  });
+  std::string out;
+  for (int expected = 0; expected < count;) {
+    if (queue.try_pop_front(out)) {
+      ASSERT_EQ(out, std::to_string(expected) + std::string(20, 'x'));
+      ++expected;
+    }
+  }
+  producer.join();
+}
+
+TEST(work_stealing_deque, owner_is_lifo_thieves_are_fifo) {
+  WorkStealingDeque<int> deque(2);
+  for (int i = 0; i < 10; ++i) {
+    deque.push_back(i);
+  }
+  EXPECT_EQ(deque.size(), 10u);
+  int out = 0;
+  ASSERT_TRUE(deque.try_pop_back(out));
+  EXPECT_EQ(out, 9);
+  ASSERT_TRUE(deque.try_steal(out));
+  EXPECT_EQ(out, 0);
+  ASSERT_TRUE(deque.try_steal(out));
+  EXPECT_EQ(out, 1);
+  while (deque.try_pop_back(out)) {
+  }
+  EXPECT_EQ(out, 2);
+  EXPECT_FALSE(deque.try_steal(out));
+  EXPECT_EQ(deque.size(), 0u);
+}
+
+namespace {
+/// The owner pushes `count` tasks in bursts and pops some of them back while `thieves`
+/// threads steal. Every task must be taken exactly once.
+void StressOwnerAndThieves(int thieves, int count, size_t capasity) {
+  WorkStealingDeque<int> deque(capasity);
+  std::vector<std::atomic<int>> taken(count);
+  std::atomic<int> total{0};
+  std::atomic<bool> done{false};
+  auto take = [&](int task) {
+    taken[task].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+  };
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thieves; ++t) {
+    threads.emplace_back([&] {
+      int task = 0;
+      while (!done.load(std::memory_order_acquire)) {
+        if (deque.try_steal(task)) {
+          take(task);
+        }
+      }
+    });
+  }
+  int task = 0;
+  for (int pushed = 0; pushed < count;) {
+    for (int burst = 0; burst < 64 && pushed < count; ++burst) {
+      deque.push_back(pushed++);
+    }
+    for (int pop = 0; pop < 16 && deque.try_pop_back(task); ++pop) {
+      take(task);
+    }
+  }
+  while (deque.try_pop_back(task)) {
+    take(task);
+  }
+  while (total.load(std::memory_order_relaxed) < count) {
+    std::this_thread::yield();
+  }
+  done.store(true, std::memory_order_release);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(taken[i].load(), 1) << "task " << i;
+  }
+}
+}
+
+TEST(work_stealing_deque, stress_one_thief) { StressOwnerAndThieves(1, 200'000, 1024); }
+
+TEST(work_stealing_deque, stress_many_thieves) { StressOwnerAndThieves(4, 200'000, 1024); }
+
+TEST(work_stealing_deque, stress_growth_under_steals) { StressOwnerAndThieves(3, 100'000, 2); }
+
+TEST(work_stealing_deque, stress_last_element_race) {
+  // Owner pushes one task at a time and immediately tries to pop it back, so nearly every
+  // pop races a steal for the final element.
+  const int count = 100'000;
+  WorkStealingDeque<int> deque(4);
+  std::vector<std::atomic<int>> taken(count);
+  std::atomic<bool> done{false};
+  std::thread thief([&] {
+    int task = 0;
+    while (!done.load(std::memory_order_acquire)) {
+      if (deque.try_steal(task)) {
+        taken[task].fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  });
+  int task = 0;
+  for (int i = 0; i < count; ++i) {
+    deque.push_back(i);
+    if (deque.try_pop_back(task)) {
+      taken[task].fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  while (deque.size() > 0) {
+    std::this_thread::yield();
+  }
+  done.store(true, std::memory_order_release);
+  thief.join();
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(taken[i].load(), 1) << "task " << i;
+  }
+}
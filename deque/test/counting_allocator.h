@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+/// Allocation counters shared by every CountingAllocator built on them.
+struct AllocationCounts {
+  size_t allocations = 0;
+  size_t deallocations = 0;
+  size_t live_bytes = 0;
+};
+
+/// Stateful allocator over std::allocator that records every call. Allocators compare equal
+/// when they share counters; propagation on move assignment is a template switch.
+template<typename T, bool Propagate = false>
+struct CountingAllocator {
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+  using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+  using propagate_on_container_swap = std::bool_constant<Propagate>;
+
+  template<typename U>
+  struct rebind {
+    using other = CountingAllocator<U, Propagate>;
+  };
+
+  explicit CountingAllocator(AllocationCounts* counts) : counts(counts) {}
+
+  template<typename U>
+  CountingAllocator(const CountingAllocator<U, Propagate>& other) : counts(other.counts) {}
+
+  T* allocate(size_t count) {
+    ++counts->allocations;
+    counts->live_bytes += count * sizeof(T);
+    return std::allocator<T>().allocate(count);
+  }
+
+  void deallocate(T* ptr, size_t count) {
+    ++counts->deallocations;
+    counts->live_bytes -= count * sizeof(T);
+    std::allocator<T>().deallocate(ptr, count);
+  }
+
+  template<typename U>
+  bool operator==(const CountingAllocator<U, Propagate>& other) const { return counts == other.counts; }
+
+  AllocationCounts* counts;
+};
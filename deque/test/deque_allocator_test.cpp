@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "counting_allocator.h"
+#include "deque.hpp"
+
+namespace {
+template<bool Propagate>
+using CountedDeque = Deque<std::string, 4, CountingAllocator<std::string, Propagate>>;
+}
+
+TEST(deque_allocator, every_block_and_map_comes_from_the_allocator) {
+  AllocationCounts counts;
+  {
+    CountedDeque<false> deque{CountingAllocator<std::string, false>(&counts)};
+    for (int i = 0; i < 100; ++i) {
+      deque.push_back(std::to_string(i));
+      deque.push_front(std::to_string(-i));
+    }
+    std::vector<std::string> middle(7, "x");
+    deque.insert(deque.begin() + 50, middle.begin(), middle.end());
+    deque.shrink_to_fit();
+    EXPECT_GT(counts.allocations, 0u);
+    EXPECT_EQ(deque.get_allocator().counts, &counts);
+  }
+  EXPECT_EQ(counts.allocations, counts.deallocations);
+  EXPECT_EQ(counts.live_bytes, 0u);
+}
+
+TEST(deque_allocator, copy_keeps_allocator) {
+  AllocationCounts counts;
+  CountedDeque<false> source{CountingAllocator<std::string, false>(&counts)};
+  source.push_back("a");
+  CountedDeque<false> copy(source);
+  EXPECT_EQ(copy.get_allocator().counts, &counts);
+  EXPECT_EQ(copy[0], "a");
+}
+
+TEST(deque_allocator, copy_with_explicit_allocator) {
+  AllocationCounts source_counts;
+  AllocationCounts target_counts;
+  CountedDeque<false> source{CountingAllocator<std::string, false>(&source_counts)};
+  source.push_back("a");
+  size_t source_allocations = source_counts.allocations;
+  CountedDeque<false> copy(source, CountingAllocator<std::string, false>(&target_counts));
+  EXPECT_EQ(source_counts.allocations, source_allocations);
+  EXPECT_GT(target_counts.allocations, 0u);
+}
+
+TEST(deque_allocator, move_assignment_between_unequal_allocators_reallocates) {
+  AllocationCounts left_counts;
+  AllocationCounts right_counts;
+  CountedDeque<false> left{CountingAllocator<std::string, false>(&left_counts)};
+  CountedDeque<false> right{CountingAllocator<std::string, false>(&right_counts)};
+  for (int i = 0; i < 20; ++i) {
+    right.push_back(std::to_string(i));
+  }
+  left = std::move(right);
+  EXPECT_EQ(left.get_allocator().counts, &left_counts);
+  EXPECT_GT(left_counts.allocations, 0u);
+  ASSERT_EQ(left.size(), 20u);
+  EXPECT_EQ(left[19], "19");
+}
+
+TEST(deque_allocator, propagating_move_assignment_steals) {
+  AllocationCounts left_counts;
+  AllocationCounts right_counts;
+  CountedDeque<true> left{CountingAllocator<std::string, true>(&left_counts)};
+  CountedDeque<true> right{CountingAllocator<std::string, true>(&right_counts)};
+  left.push_back("old");
+  for (int i = 0; i < 20; ++i) {
+    right.push_back(std::to_string(i));
+  }
+  size_t right_allocations = right_counts.allocations;
+  left = std::move(right);
+  EXPECT_EQ(left.get_allocator().counts, &right_counts);
+  EXPECT_EQ(right_counts.allocations, right_allocations);
+  EXPECT_EQ(left_counts.live_bytes, 0u);
+  EXPECT_EQ(left[0], "0");
+}
+
+TEST(deque_allocator, propagating_copy_assignment_adopts_source_allocator) {
+  AllocationCounts left_counts;
+  AllocationCounts right_counts;
+  CountedDeque<true> left{CountingAllocator<std::string, true>(&left_counts)};
+  CountedDeque<true> right{CountingAllocator<std::string, true>(&right_counts)};
+  left.push_back("old");
+  right.push_back("new");
+  left = right;
+  EXPECT_EQ(left.get_allocator().counts, &right_counts);
+  EXPECT_EQ(left_counts.live_bytes, 0u);
+  EXPECT_EQ(left[0], "new");
+}
+
+TEST(deque_allocator, runs_from_an_arena_without_the_heap) {
+  char buffer[16 * 1024];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+  Deque<int, 64, std::pmr::polymorphic_allocator<int>> deque{std::pmr::polymorphic_allocator<int>(&arena)};
+  for (int i = 0; i < 1000; ++i) {
+    deque.push_back(i);
+  }
+  EXPECT_EQ(deque[999], 999);
+  EXPECT_EQ(deque.get_allocator().resource(), &arena);
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <string>
+
+#include "counting_allocator.h"
+#include "deque.hpp"
+
+TEST(deque_block_size, targets_half_to_four_kilobytes) {
+  EXPECT_EQ(DequeBlockSize<char>(), 512u);
+  EXPECT_EQ(DequeBlockSize<int>(), 128u);
+  EXPECT_EQ(DequeBlockSize<double>(), 64u);
+  EXPECT_EQ((DequeBlockSize<std::array<char, 100>>()), 16u);
+  EXPECT_EQ((DequeBlockSize<std::array<char, 1000>>()), 4u);
+  EXPECT_EQ((DequeBlockSize<std::array<char, 10000>>()), 1u);
+}
+
+TEST(deque_block_size, is_always_a_power_of_two) {
+  EXPECT_TRUE(std::has_single_bit(DequeBlockSize<std::array<char, 3>>()));
+  EXPECT_TRUE(std::has_single_bit(DequeBlockSize<std::array<char, 24>>()));
+  EXPECT_TRUE(std::has_single_bit(DequeBlockSize<std::array<char, 300>>()));
+}
+
+TEST(deque_block_size, can_be_overridden) {
+  Deque<int, 4> small;
+  for (int i = 0; i < 100; ++i) {
+    small.push_back(i);
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(small[i], i);
+  }
+}
+
+TEST(deque_lazy_blocks, empty_deque_allocates_nothing) {
+  AllocationCounts counts;
+  Deque<int, 128, CountingAllocator<int>> deque{CountingAllocator<int>(&counts)};
+  EXPECT_EQ(counts.allocations, 0u);
+  EXPECT_EQ(deque.memory_usage(), 0u);
+}
+
+TEST(deque_lazy_blocks, copying_an_empty_deque_allocates_nothing) {
+  AllocationCounts counts;
+  Deque<int, 128, CountingAllocator<int>> empty{CountingAllocator<int>(&counts)};
+  Deque<int, 128, CountingAllocator<int>> copy(empty);
+  EXPECT_EQ(copy.memory_usage(), 0u);
+  EXPECT_EQ(counts.allocations, 0u);
+
+  Deque<int, 128, CountingAllocator<int>> emptied{CountingAllocator<int>(&counts)};
+  emptied.push_back(1);
+  emptied.pop_back();
+  Deque<int, 128, CountingAllocator<int>> second(emptied);
+  EXPECT_EQ(second.memory_usage(), 0u);
+  copy = emptied;
+  EXPECT_EQ(copy.memory_usage(), 0u);
+  copy.push_back(7);
+  EXPECT_EQ(copy[0], 7);
+}
+
+TEST(deque_lazy_blocks, only_touched_blocks_are_allocated) {
+  AllocationCounts counts;
+  Deque<int, 128, CountingAllocator<int>> deque{CountingAllocator<int>(&counts)};
+  deque.push_back(1);
+  size_t map_and_one_block = counts.allocations;
+  EXPECT_EQ(map_and_one_block, 2u);
+  for (int i = 1; i < 128; ++i) {
+    deque.push_back(i);
+  }
+  EXPECT_EQ(counts.allocations, map_and_one_block);
+  deque.push_back(128);
+  EXPECT_GT(counts.allocations, map_and_one_block);
+  EXPECT_LE(counts.live_bytes, 2 * 128 * sizeof(int) + 16 * sizeof(int*));
+}
+
+TEST(deque_lazy_blocks, sized_constructor_allocates_only_needed_blocks) {
+  AllocationCounts counts;
+  {
+    Deque<int, 128, CountingAllocator<int>> deque(1000, CountingAllocator<int>(&counts));
+    EXPECT_EQ(deque.size(), 1000u);
+    // The map plus ceil(1000 / 128) blocks, however large the map is.
+    EXPECT_EQ(counts.allocations, 1u + 8u);
+  }
+  EXPECT_EQ(counts.live_bytes, 0u);
+}
+
+TEST(deque_lazy_blocks, memory_usage_tracks_blocks) {
+  Deque<std::string> deque;
+  size_t previous = 0;
+  for (int i = 0; i < 1000; ++i) {
+    deque.push_back(std::to_string(i));
+    EXPECT_GE(deque.memory_usage(), previous);
+    previous = deque.memory_usage();
+  }
+  EXPECT_GE(deque.memory_usage(), 1000 * sizeof(std::string));
+  EXPECT_LT(deque.memory_usage(), 4 * 1000 * sizeof(std::string));
+}
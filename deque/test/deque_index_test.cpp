@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <random>
+#include <stdexcept>
+
+#include "deque.hpp"
+
+namespace {
+template<size_t N>
+struct BlockSize {
+  static const size_t value = N;
+};
+
+/// Builds the same contents in a Deque and a std::deque, growing at both ends so the live
+/// range starts and ends mid-block and the map has been recentred and expanded.
+template<typename D>
+void Fill(D& deque, std::deque<int>& expected, int count) {
+  for (int i = 0; i < count; ++i) {
+    if (i % 3 == 0) {
+      deque.push_front(-i);
+      expected.push_front(-i);
+    } else {
+      deque.push_back(i);
+      expected.push_back(i);
+    }
+  }
+}
+}
+
+template<typename Size>
+class DequeIndexTest : public ::testing::Test {};
+
+using BlockSizes = ::testing::Types<BlockSize<1>, BlockSize<2>, BlockSize<4>, BlockSize<8>, BlockSize<128>>;
+TYPED_TEST_SUITE(DequeIndexTest, BlockSizes);
+
+TYPED_TEST(DequeIndexTest, random_access_matches_std) {
+  Deque<int, TypeParam::value> deque;
+  std::deque<int> expected;
+  Fill(deque, expected, 1000);
+  std::mt19937 random(1);
+  for (int i = 0; i < 5000; ++i) {
+    size_t pos = random() % expected.size();
+    ASSERT_EQ(deque[pos], expected[pos]);
+    ASSERT_EQ(deque.at(pos), expected[pos]);
+  }
+  EXPECT_THROW(deque.at(expected.size()), std::out_of_range);
+  const auto& constant = deque;
+  EXPECT_EQ(constant[17], expected[17]);
+}
+
+TYPED_TEST(DequeIndexTest, iteration_matches_std) {
+  Deque<int, TypeParam::value> deque;
+  std::deque<int> expected;
+  Fill(deque, expected, 777);
+  size_t i = 0;
+  for (auto it = deque.begin(); it != deque.end(); ++it, ++i) {
+    ASSERT_EQ(*it, expected[i]);
+  }
+  EXPECT_EQ(i, expected.size());
+  for (auto it = deque.end(); it != deque.begin();) {
+    --it;
+    ASSERT_EQ(*it, expected[--i]);
+  }
+  i = expected.size();
+  for (auto it = deque.rbegin(); it != deque.rend(); ++it) {
+    ASSERT_EQ(*it, expected[--i]);
+  }
+  EXPECT_EQ(i, 0u);
+}
+
+TYPED_TEST(DequeIndexTest, iterator_arithmetic_matches_std) {
+  Deque<int, TypeParam::value> deque;
+  std::deque<int> expected;
+  Fill(deque, expected, 500);
+  std::mt19937 random(2);
+  int size = static_cast<int>(expected.size());
+  for (int i = 0; i < 2000; ++i) {
+    int from = random() % size;
+    int to = random() % (size + 1);
+    auto it = deque.begin() + from;
+    ASSERT_EQ(*it, expected[from]);
+    auto moved = it + (to - from);
+    ASSERT_EQ(moved - deque.begin(), to);
+    ASSERT_EQ(moved - it, to - from);
+    if (to < size) {
+      ASSERT_EQ(*moved, expected[to]);
+    }
+    ASSERT_EQ(from < to, it < moved);
+    ASSERT_EQ(from == to, it == moved);
+    auto back = moved;
+    back -= to - from;
+    ASSERT_EQ(back, it);
+    auto reverse = deque.rbegin() + from;
+    ASSERT_EQ(*reverse, expected[size - 1 - from]);
+  }
+  EXPECT_EQ(deque.end() - 1 - deque.begin(), size - 1);
+  EXPECT_EQ(*(deque.end() - 1), expected.back());
+  EXPECT_EQ(deque.rend() - deque.rbegin(), size);
+}
+
+TYPED_TEST(DequeIndexTest, pop_keeps_other_iterators_valid) {
+  Deque<int, TypeParam::value> deque;
+  std::deque<int> expected;
+  Fill(deque, expected, 300);
+  auto middle = deque.begin() + 150;
+  int value = *middle;
+  const int* address = &*middle;
+  for (int i = 0; i < 100; ++i) {
+    deque.pop_front();
+    deque.pop_back();
+  }
+  EXPECT_EQ(*middle, value);
+  EXPECT_EQ(&*middle, address);
+  EXPECT_EQ(middle - deque.begin(), 50);
+}
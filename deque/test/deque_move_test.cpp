@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "counting_allocator.h"
+#include "deque.hpp"
+
+namespace {
+/// Counts copies and moves, so tests can tell relocation by move from relocation by copy.
+struct Tracked {
+  static inline size_t copies = 0;
+  static inline size_t moves = 0;
+
+  explicit Tracked(int value = 0) : value(value) {}
+
+  Tracked(const Tracked& other) : value(other.value) { ++copies; }
+
+  Tracked(Tracked&& other) noexcept : value(other.value) { ++moves; }
+
+  Tracked& operator=(const Tracked& other) {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+
+  Tracked& operator=(Tracked&& other) noexcept {
+    value = other.value;
+    ++moves;
+    return *this;
+  }
+
+  static void Reset() {
+    copies = 0;
+    moves = 0;
+  }
+
+  int value;
+};
+
+template<typename D>
+void ExpectValues(D& deque, std::initializer_list<int> values) {
+  ASSERT_EQ(deque.size(), values.size());
+  size_t i = 0;
+  for (int value : values) {
+    EXPECT_EQ(deque[i++].value, value);
+  }
+}
+}
+
+TEST(deque_move, constructor_steals_block_map) {
+  Deque<std::string> source;
+  for (int i = 0; i < 1000; ++i) {
+    source.push_back(std::to_string(i));
+  }
+  const std::string* first = &source[0];
+  Deque<std::string> target(std::move(source));
+  EXPECT_EQ(&target[0], first);
+  EXPECT_EQ(target.size(), 1000u);
+  EXPECT_EQ(source.size(), 0u);
+  source.push_back("reusable");
+  EXPECT_EQ(source[0], "reusable");
+}
+
+TEST(deque_move, assignment_steals_block_map) {
+  AllocationCounts counts;
+  CountingAllocator<int> alloc(&counts);
+  Deque<int, 128, CountingAllocator<int>> source(alloc);
+  Deque<int, 128, CountingAllocator<int>> target(alloc);
+  for (int i = 0; i < 1000; ++i) {
+    source.push_back(i);
+  }
+  target.push_back(-1);
+  size_t allocations = counts.allocations;
+  const int* first = &source[0];
+  target = std::move(source);
+  EXPECT_EQ(counts.allocations, allocations);
+  EXPECT_EQ(&target[0], first);
+  EXPECT_EQ(target.size(), 1000u);
+  EXPECT_EQ(source.size(), 0u);
+}
+
+TEST(deque_move, operations_are_noexcept) {
+  EXPECT_TRUE(std::is_nothrow_move_constructible_v<Deque<std::string>>);
+  EXPECT_TRUE(std::is_nothrow_move_assignable_v<Deque<std::string>>);
+}
+
+TEST(deque_move, rvalue_push_does_not_copy) {
+  Tracked::Reset();
+  Deque<Tracked> deque;
+  for (int i = 0; i < 100; ++i) {
+    deque.push_back(Tracked(i));
+    deque.push_front(Tracked(-i));
+  }
+  EXPECT_EQ(Tracked::copies, 0u);
+  EXPECT_EQ(Tracked::moves, 200u);
+}
+
+TEST(deque_move, emplace_constructs_in_place) {
+  Tracked::Reset();
+  Deque<Tracked> deque;
+  Tracked& back = deque.emplace_back(1);
+  Tracked& front = deque.emplace_front(0);
+  EXPECT_EQ(&back, &deque[1]);
+  EXPECT_EQ(&front, &deque[0]);
+  EXPECT_EQ(Tracked::copies + Tracked::moves, 0u);
+  ExpectValues(deque, {0, 1});
+}
+
+TEST(deque_move, holds_move_only_types) {
+  Deque<std::unique_ptr<int>> deque;
+  for (int i = 0; i < 300; ++i) {
+    deque.push_back(std::make_unique<int>(i));
+  }
+  deque.emplace(deque.begin() + 5, std::make_unique<int>(-1));
+  deque.erase(deque.begin());
+  EXPECT_EQ(*deque[4], -1);
+  EXPECT_EQ(*deque[5], 5);
+  EXPECT_EQ(deque.size(), 300u);
+}
+
+TEST(deque_move, insert_and_erase_relocate_by_move) {
+  Deque<Tracked, 4> deque;
+  for (int i = 0; i < 10; ++i) {
+    deque.emplace_back(i);
+  }
+  Tracked::Reset();
+  deque.emplace(deque.begin() + 3, 42);
+  deque.erase(deque.begin() + 1);
+  EXPECT_EQ(Tracked::copies, 0u);
+  EXPECT_GT(Tracked::moves, 0u);
+  ExpectValues(deque, {0, 2, 42, 3, 4, 5, 6, 7, 8, 9});
+}
+
+namespace {
+/// Throwing move: relocation must fall back to copies to keep the old elements intact.
+struct CopyPreferred {
+  explicit CopyPreferred(int value = 0) : value(value) {}
+
+  CopyPreferred(const CopyPreferred&) = default;
+
+  CopyPreferred& operator=(const CopyPreferred& other) {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+
+  CopyPreferred& operator=(CopyPreferred&& other) {
+    value = other.value;
+    ++moves;
+    return *this;
+  }
+
+  static inline size_t copies = 0;
+  static inline size_t moves = 0;
+  int value;
+};
+}
+
+TEST(deque_move, throwing_move_relocates_by_copy) {
+  Deque<CopyPreferred, 4> deque;
+  for (int i = 0; i < 10; ++i) {
+    deque.emplace_back(i);
+  }
+  deque.erase(deque.begin());
+  EXPECT_EQ(CopyPreferred::moves, 0u);
+  EXPECT_GT(CopyPreferred::copies, 0u);
+  EXPECT_EQ(deque[0].value, 1);
+}
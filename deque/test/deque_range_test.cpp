@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <list>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "deque.hpp"
+
+namespace {
+template<typename T>
+T MakeValue(int value) {
+  if constexpr (std::is_same<T, std::string>::value) {
+    return "value-" + std::to_string(value);
+  } else {
+    return value;
+  }
+}
+
+template<typename D, typename T>
+void ExpectSame(const D& deque, const std::deque<T>& expected) {
+  ASSERT_EQ(deque.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(deque[i], expected[i]) << "at " << i;
+  }
+}
+
+/// Random mix of range operations checked against std::deque. Block size 4 makes almost every
+/// operation cross block boundaries, on both the memmove path (int) and the element path.
+template<typename T>
+void Fuzz(unsigned seed) {
+  Deque<T, 4> deque;
+  std::deque<T> expected;
+  std::mt19937 random(seed);
+  int next = 0;
+  for (int step = 0; step < 3000; ++step) {
+    std::vector<T> items(random() % 20);
+    for (T& item : items) {
+      item = MakeValue<T>(next++);
+    }
+    size_t pos = expected.empty() ? 0 : random() % (expected.size() + 1);
+    switch (random() % 8) {
+      case 0:
+        deque.insert(deque.begin() + pos, items.begin(), items.end());
+        // libstdc++ 12 clobbers an element when inserting an empty range into the back half.
+        if (!items.empty()) {
+          expected.insert(expected.begin() + pos, items.begin(), items.end());
+        }
+        break;
+      case 1: {
+        size_t last = pos + random() % (expected.size() - pos + 1);
+        deque.erase(deque.begin() + pos, deque.begin() + last);
+        expected.erase(expected.begin() + pos, expected.begin() + last);
+        break;
+      }
+      case 2:
+        deque.append(std::span<const T>(items));
+        expected.insert(expected.end(), items.begin(), items.end());
+        break;
+      case 3:
+        deque.prepend(std::span<const T>(items));
+        expected.insert(expected.begin(), items.begin(), items.end());
+        break;
+      case 4: {
+        std::list<T> source(items.begin(), items.end());
+        deque.prepend(source.begin(), source.end());
+        expected.insert(expected.begin(), items.begin(), items.end());
+        break;
+      }
+      case 5: {
+        size_t count = random() % 200;
+        deque.resize(count, MakeValue<T>(-1));
+        expected.resize(count, MakeValue<T>(-1));
+        break;
+      }
+      case 6:
+        if (random() % 10 == 0) {
+          deque.assign(items.begin(), items.end());
+          expected.assign(items.begin(), items.end());
+        }
+        break;
+      default:
+        deque.push_front(MakeValue<T>(next));
+        expected.push_front(MakeValue<T>(next++));
+        break;
+    }
+    SCOPED_TRACE("step " + std::to_string(step));
+    ExpectSame(deque, expected);
+    if (::testing::Test::HasFailure()) {
+      return;
+    }
+  }
+}
+}
+
+TEST(deque_range, fuzz_trivially_copyable) {
+  for (unsigned seed = 0; seed < 5; ++seed) {
+    Fuzz<int>(seed);
+  }
+}
+
+TEST(deque_range, fuzz_non_trivial) {
+  for (unsigned seed = 0; seed < 5; ++seed) {
+    Fuzz<std::string>(seed);
+  }
+}
+
+TEST(deque_range, insert_from_single_pass_input) {
+  Deque<int> deque;
+  deque.append(std::span<const int>(std::vector<int>{1, 5}));
+  std::istringstream input("2 3 4");
+  deque.insert(deque.begin() + 1, std::istream_iterator<int>(input), std::istream_iterator<int>());
+  std::vector<int> expected{1, 2, 3, 4, 5};
+  ASSERT_EQ(deque.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(deque[i], expected[i]);
+  }
+}
+
+TEST(deque_range, assign_count_and_resize_default) {
+  Deque<std::string> deque;
+  deque.assign(3, "x");
+  deque.resize(5);
+  ASSERT_EQ(deque.size(), 5u);
+  EXPECT_EQ(deque[2], "x");
+  EXPECT_EQ(deque[4], "");
+  deque.resize(1);
+  EXPECT_EQ(deque.size(), 1u);
+}
+
+namespace {
+struct ThrowingCopy {
+  static inline int budget = -1;
+
+  explicit ThrowingCopy(int value) : value(value) {}
+
+  ThrowingCopy(const ThrowingCopy& other) : value(other.value) {
+    if (budget == 0) {
+      throw std::runtime_error("copy");
+    }
+    --budget;
+  }
+
+  ThrowingCopy& operator=(const ThrowingCopy&) = default;
+
+  int value;
+};
+}
+
+TEST(deque_range, failed_append_leaves_deque_unchanged) {
+  Deque<ThrowingCopy, 4> deque;
+  for (int i = 0; i < 10; ++i) {
+    deque.emplace_back(i);
+  }
+  std::vector<ThrowingCopy> items;
+  for (int i = 0; i < 10; ++i) {
+    items.emplace_back(100 + i);
+  }
+  ThrowingCopy::budget = 5;
+  EXPECT_THROW(deque.append(items.begin(), items.end()), std::runtime_error);
+  ThrowingCopy::budget = 5;
+  EXPECT_THROW(deque.assign(items.begin(), items.end()), std::runtime_error);
+  ThrowingCopy::budget = -1;
+  ASSERT_EQ(deque.size(), 10u);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(deque[i].value, i);
+  }
+}
+
+namespace {
+/// Erases a middle range from each side with no spare blocks allowed; the freed blocks must go
+/// back exactly as element-wise pops would return them.
+template<typename T>
+void EraseReleasesBlocks() {
+  for (bool front_side : {true, false}) {
+    Deque<T, 4> deque;
+    std::deque<T> expected;
+    deque.set_spare_block_limit(0);
+    for (int i = 0; i < 400; ++i) {
+      deque.push_back(MakeValue<T>(i));
+      expected.push_back(MakeValue<T>(i));
+    }
+    size_t before = deque.memory_usage();
+    size_t from = front_side ? 10 : 90;
+    size_t to = front_side ? 310 : 390;
+    deque.erase(deque.begin() + from, deque.begin() + to);
+    expected.erase(expected.begin() + from, expected.begin() + to);
+    ExpectSame(deque, expected);
+    EXPECT_LE(deque.memory_usage() + 74 * 4 * sizeof(T), before);
+
+    Deque<T, 4> popped;
+    popped.set_spare_block_limit(0);
+    for (int i = 0; i < 400; ++i) {
+      popped.push_back(MakeValue<T>(i));
+    }
+    for (int i = 0; i < 300; ++i) {
+      front_side ? popped.pop_front() : popped.pop_back();
+    }
+    EXPECT_EQ(deque.memory_usage(), popped.memory_usage());
+  }
+}
+}
+
+TEST(deque_range, erase_releases_vacated_blocks_trivially_copyable) { EraseReleasesBlocks<int>(); }
+
+TEST(deque_range, erase_releases_vacated_blocks_non_trivial) { EraseReleasesBlocks<std::string>(); }
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "counting_allocator.h"
+#include "deque.hpp"
+
+namespace {
+using CountedDeque = Deque<int, 16, CountingAllocator<int>>;
+}
+
+TEST(deque_recycle, steady_fifo_makes_no_allocations) {
+  AllocationCounts counts;
+  CountedDeque deque{CountingAllocator<int>(&counts)};
+  const int live = 1000;
+  int next = 0;
+  int expected = 0;
+  for (; next < live; ++next) {
+    deque.push_back(next);
+  }
+  // Warm up until the map and the spare blocks stop changing.
+  for (int i = 0; i < 10 * live; ++i) {
+    deque.push_back(next++);
+    ASSERT_EQ(deque[0], expected++);
+    deque.pop_front();
+  }
+  size_t allocations = counts.allocations;
+  size_t deallocations = counts.deallocations;
+  size_t memory = deque.memory_usage();
+  for (int i = 0; i < 2'000'000; ++i) {
+    deque.push_back(next++);
+    ASSERT_EQ(deque[0], expected++);
+    deque.pop_front();
+  }
+  EXPECT_EQ(counts.allocations, allocations);
+  EXPECT_EQ(counts.deallocations, deallocations);
+  EXPECT_EQ(deque.memory_usage(), memory);
+  EXPECT_EQ(deque.size(), static_cast<size_t>(live));
+}
+
+TEST(deque_recycle, steady_reverse_fifo_makes_no_allocations) {
+  AllocationCounts counts;
+  CountedDeque deque{CountingAllocator<int>(&counts)};
+  for (int i = 0; i < 500; ++i) {
+    deque.push_front(i);
+  }
+  for (int i = 0; i < 5000; ++i) {
+    deque.push_front(i);
+    deque.pop_back();
+  }
+  size_t allocations = counts.allocations;
+  for (int i = 0; i < 1'000'000; ++i) {
+    deque.push_front(i);
+    deque.pop_back();
+  }
+  EXPECT_EQ(counts.allocations, allocations);
+}
+
+TEST(deque_recycle, bursty_fifo_stays_bounded) {
+  AllocationCounts counts;
+  CountedDeque deque{CountingAllocator<int>(&counts)};
+  std::mt19937 random(7);
+  int next = 0;
+  int expected = 0;
+  auto step = [&] {
+    size_t burst = random() % 64;
+    for (size_t i = 0; i < burst && deque.size() < 2000; ++i) {
+      deque.push_back(next++);
+    }
+    size_t drain = random() % 64;
+    for (size_t i = 0; i < drain && deque.size() > 0; ++i) {
+      ASSERT_EQ(deque[0], expected++);
+      deque.pop_front();
+    }
+  };
+  for (int i = 0; i < 20'000; ++i) {
+    step();
+  }
+  size_t allocations = counts.allocations;
+  size_t live_bytes = counts.live_bytes;
+  for (int i = 0; i < 200'000; ++i) {
+    step();
+  }
+  EXPECT_EQ(counts.allocations, allocations);
+  EXPECT_EQ(counts.live_bytes, live_bytes);
+}
+
+TEST(deque_recycle, spare_block_limit_frees_vacated_blocks) {
+  AllocationCounts counts;
+  CountedDeque deque{CountingAllocator<int>(&counts)};
+  for (int i = 0; i < 16 * 100; ++i) {
+    deque.push_back(i);
+  }
+  size_t peak = counts.live_bytes;
+  deque.set_spare_block_limit(2);
+  while (deque.size() > 16) {
+    deque.pop_front();
+  }
+  // At most the live block and two spares remain out of a hundred.
+  EXPECT_GE(peak - counts.live_bytes, 97 * 16 * sizeof(int));
+  EXPECT_EQ(deque[0], 16 * 99);
+}
+
+TEST(deque_recycle, shrink_to_fit_keeps_only_the_live_blocks) {
+  AllocationCounts counts;
+  CountedDeque deque{CountingAllocator<int>(&counts)};
+  for (int i = 0; i < 16 * 100; ++i) {
+    deque.push_back(i);
+  }
+  while (deque.size() > 20) {
+    deque.pop_front();
+  }
+  deque.shrink_to_fit();
+  // The twenty survivors straddle two blocks, held by a map of the default two slots plus guards.
+  size_t needed = 2 * 16 * sizeof(int) + (2 + 2) * sizeof(int*);
+  EXPECT_EQ(deque.memory_usage(), needed);
+  EXPECT_EQ(counts.live_bytes, needed);
+  EXPECT_EQ(deque[0], 16 * 100 - 20);
+  EXPECT_EQ(deque[19], 16 * 100 - 1);
+}
+
+TEST(deque_recycle, assignment_carries_the_spare_block_limit) {
+  AllocationCounts counts;
+  CountedDeque source{CountingAllocator<int>(&counts)};
+  source.set_spare_block_limit(0);
+  CountedDeque copied{CountingAllocator<int>(&counts)};
+  copied = source;
+  CountedDeque moved{CountingAllocator<int>(&counts)};
+  moved = CountedDeque(source);
+  for (CountedDeque* deque : {&copied, &moved}) {
+    for (int i = 0; i < 16 * 10; ++i) {
+      deque->push_back(i);
+    }
+    size_t before = deque->memory_usage();
+    while (deque->size() > 1) {
+      deque->pop_front();
+    }
+    EXPECT_EQ(before - deque->memory_usage(), 9 * 16 * sizeof(int));
+  }
+}
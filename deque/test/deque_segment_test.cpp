@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "deque.hpp"
+
+namespace {
+/// A Deque<int, 8> whose live range starts mid-block, so segments are ragged at both ends.
+Deque<int, 8> MakeDeque(int count) {
+  Deque<int, 8> deque;
+  for (int i = 0; i < count; ++i) {
+    deque.push_back(i);
+  }
+  for (int i = 1; i <= 5; ++i) {
+    deque.push_front(-i);
+  }
+  return deque;
+}
+
+std::vector<int> Contents(const Deque<int, 8>& deque) {
+  std::vector<int> contents;
+  for (size_t i = 0; i < deque.size(); ++i) {
+    contents.push_back(deque[i]);
+  }
+  return contents;
+}
+}
+
+TEST(deque_segments, cover_range_in_order_within_blocks) {
+  Deque<int, 8> deque = MakeDeque(100);
+  std::vector<int> contents = Contents(deque);
+  for (int from = 0; from < 20; ++from) {
+    for (int to = from; to < static_cast<int>(deque.size()); to += 7) {
+      std::vector<int> seen;
+      ::for_each_segment(deque.begin() + from, deque.begin() + to, [&seen](int* first, int* last) {
+        EXPECT_LT(first, last);
+        EXPECT_LE(last - first, 8);
+        seen.insert(seen.end(), first, last);
+      });
+      std::vector<int> expected(contents.begin() + from, contents.begin() + to);
+      EXPECT_EQ(seen, expected);
+    }
+  }
+}
+
+TEST(deque_segments, segments_never_cross_blocks) {
+  Deque<int, 8> deque = MakeDeque(100);
+  size_t segments = 0;
+  size_t index = 0;
+  deque.for_each_segment([&](int* first, int* last) {
+    ++segments;
+    // Each segment is contiguous memory holding exactly the next elements.
+    for (int* element = first; element != last; ++element) {
+      EXPECT_EQ(element, &deque[index++]);
+    }
+  });
+  EXPECT_EQ(index, deque.size());
+  // 105 elements starting 5 before a block boundary: a 5-element head plus 13 full blocks.
+  EXPECT_EQ(segments, 14u);
+}
+
+TEST(deque_segments, returning_false_stops_the_walk) {
+  Deque<int, 8> deque = MakeDeque(100);
+  size_t calls = 0;
+  deque.for_each_segment([&calls](int*, int*) { return ++calls < 3; });
+  EXPECT_EQ(calls, 3u);
+}
+
+TEST(deque_segments, reverse_iterators_walk_backwards) {
+  Deque<int, 8> deque = MakeDeque(30);
+  std::vector<int> seen;
+  ::for_each_segment(deque.rbegin(), deque.rend(), [&seen](int* first, int* last) { seen.insert(seen.end(), first, last); });
+  std::vector<int> expected = Contents(deque);
+  std::reverse(expected.begin(), expected.end());
+  EXPECT_EQ(seen, expected);
+}
+
+TEST(deque_segments, algorithms_match_std) {
+  Deque<int, 8> deque = MakeDeque(500);
+  std::vector<int> expected = Contents(deque);
+
+  std::vector<int> copied(expected.size());
+  ::copy(deque.begin(), deque.end(), copied.begin());
+  EXPECT_EQ(copied, expected);
+
+  EXPECT_EQ(::accumulate(deque.begin() + 3, deque.end() - 4, 0LL),
+            std::accumulate(expected.begin() + 3, expected.end() - 4, 0LL));
+
+  EXPECT_EQ(::find(deque.begin(), deque.end(), 250) - deque.begin(), 255);
+  EXPECT_EQ(::find(deque.begin(), deque.end(), -3) - deque.begin(), 2);
+  EXPECT_EQ(::find(deque.begin(), deque.end(), 100000) - deque.begin(), static_cast<int>(deque.size()));
+
+  ::fill(deque.begin() + 10, deque.begin() + 50, 7);
+  std::fill(expected.begin() + 10, expected.begin() + 50, 7);
+  EXPECT_EQ(Contents(deque), expected);
+}
+
+TEST(deque_segments, sort_matches_std) {
+  std::mt19937 random(3);
+  Deque<int, 8> deque = MakeDeque(0);
+  for (int i = 0; i < 1000; ++i) {
+    deque.push_back(static_cast<int>(random() % 100));
+  }
+  std::vector<int> expected = Contents(deque);
+  ::sort(deque.begin() + 5, deque.end() - 5);
+  std::sort(expected.begin() + 5, expected.end() - 5);
+  EXPECT_EQ(Contents(deque), expected);
+  ::sort(deque.begin(), deque.end(), std::greater<>());
+  std::sort(expected.begin(), expected.end(), std::greater<>());
+  EXPECT_EQ(Contents(deque), expected);
+}
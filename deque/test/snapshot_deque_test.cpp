@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "snapshot_deque.hpp"
+
+// The reader-thread case is meant to run under ThreadSanitizer as well
+// (-DUSE_THREAD_SANITIZER=ON).
+
+namespace {
+template<typename T>
+T MakeValue(int value) {
+  if constexpr (std::is_same<T, std::string>::value) {
+    return "value-" + std::to_string(value);
+  } else {
+    return value;
+  }
+}
+
+/// Reads only through const access, so checking a snapshot never unshares it.
+template<typename T, size_t N>
+void ExpectSame(const SnapshotDeque<T, N>& deque, const std::deque<T>& expected) {
+  ASSERT_EQ(deque.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(deque[i], expected[i]) << "at " << i;
+  }
+  size_t i = 0;
+  for (const T& value : deque) {
+    ASSERT_EQ(value, expected[i++]);
+  }
+  ASSERT_EQ(i, expected.size());
+}
+
+/// Random pushes, pops and in-place writes on the owner while up to five snapshots taken along
+/// the way stay alive; every snapshot must keep the contents it was taken with.
+template<typename T>
+void Fuzz(unsigned seed) {
+  SnapshotDeque<T, 4> deque;
+  std::deque<T> expected;
+  std::vector<std::pair<SnapshotDeque<T, 4>, std::deque<T>>> snapshots;
+  std::mt19937 random(seed);
+  int next = 0;
+  for (int step = 0; step < 5000; ++step) {
+    switch (random() % 8) {
+      case 0:
+      case 1:
+        deque.push_back(MakeValue<T>(next));
+        expected.push_back(MakeValue<T>(next++));
+        break;
+      case 2:
+        deque.push_front(MakeValue<T>(next));
+        expected.push_front(MakeValue<T>(next++));
+        break;
+      case 3:
+        if (!expected.empty()) {
+          deque.pop_back();
+          expected.pop_back();
+        }
+        break;
+      case 4:
+        if (!expected.empty()) {
+          deque.pop_front();
+          expected.pop_front();
+        }
+        break;
+      case 5:
+        if (!expected.empty()) {
+          size_t pos = random() % expected.size();
+          deque[pos] = MakeValue<T>(next);
+          expected[pos] = MakeValue<T>(next++);
+        }
+        break;
+      case 6:
+        if (snapshots.size() < 5) {
+          snapshots.emplace_back(deque.snapshot(), expected);
+        }
+        break;
+      default:
+        if (!snapshots.empty()) {
+          snapshots.erase(snapshots.begin() + random() % snapshots.size());
+        }
+        break;
+    }
+    ExpectSame(deque, expected);
+    if (step % 50 == 0) {
+      for (const auto& [snapshot, frozen] : snapshots) {
+        ExpectSame(snapshot, frozen);
+      }
+    }
+  }
+  for (const auto& [snapshot, frozen] : snapshots) {
+    ExpectSame(snapshot, frozen);
+  }
+}
+}
+
+TEST(snapshot_deque, fuzz_against_std_deque_with_live_snapshots) {
+  for (unsigned seed = 0; seed < 4; ++seed) {
+    Fuzz<int>(seed);
+    Fuzz<std::string>(seed);
+  }
+}
+
+TEST(snapshot_deque, writes_unshare_only_the_touched_block) {
+  SnapshotDeque<std::string, 4> deque;
+  for (int i = 0; i < 40; ++i) {
+    deque.push_back(MakeValue<std::string>(i));
+  }
+  EXPECT_EQ(deque.shared_blocks(), 0u);
+  {
+    const SnapshotDeque<std::string, 4> snapshot = deque.snapshot();
+    EXPECT_EQ(deque.shared_blocks(), 10u);
+    EXPECT_EQ(snapshot.shared_blocks(), 10u);
+
+    deque[5] = "changed";
+    EXPECT_EQ(deque.shared_blocks(), 9u);
+    EXPECT_EQ(snapshot.shared_blocks(), 9u);
+    EXPECT_EQ(snapshot[5], "value-5");
+
+    // Appending past a full block starts a fresh one; popping a shared element copies nothing.
+    deque.push_back("tail");
+    deque.pop_front();
+    EXPECT_EQ(deque.shared_blocks(), 9u);
+    EXPECT_EQ(snapshot[0], "value-0");
+    EXPECT_EQ(snapshot.size(), 40u);
+  }
+  EXPECT_EQ(deque.shared_blocks(), 0u);
+  EXPECT_EQ(deque[4], "changed");
+}
+
+TEST(snapshot_deque, reader_iterates_snapshot_while_owner_mutates) {
+  const int count = 1000;
+  SnapshotDeque<std::string, 8> deque;
+  for (int i = 0; i < count; ++i) {
+    deque.push_back(MakeValue<std::string>(i));
+  }
+  std::thread reader([snapshot = deque.snapshot()] {
+    for (int round = 0; round < 20; ++round) {
+      int i = 0;
+      for (const std::string& value : snapshot) {
+        ASSERT_EQ(value, MakeValue<std::string>(i++));
+      }
+      ASSERT_EQ(static_cast<size_t>(i), snapshot.size());
+    }
+  });
+  for (int round = 0; round < 20; ++round) {
+    for (int i = round; i < count; i += 37) {
+      deque[i] = "written";
+    }
+    for (int i = 0; i < 10; ++i) {
+      deque.pop_front();
+      deque.push_back("appended");
+    }
+    SnapshotDeque<std::string, 8> dropped = deque.snapshot();
+  }
+  reader.join();
+  EXPECT_EQ(deque.size(), static_cast<size_t>(count));
+  EXPECT_EQ(deque.shared_blocks(), 0u);
+}
@@ -0,0 +1,69 @@
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <random>
+
+#include "list.hpp"
+#include "stack_allocator.hpp"
+
+// The README check: random additions and removals at both ends of a list,
+// with std::allocator and with stack_allocator. The live size stays small
+// while the total number of nodes ever allocated is 100 times what the
+// buffer holds, so the run only finishes if freed nodes are reused: the
+// storage has null_memory_resource upstream and would throw on overflow.
+namespace {
+const std::size_t kBuffer = 1'000'000;
+const std::size_t kNodeBytes = 3 * sizeof(void*);
+const std::size_t kOperations = 2 * 100 * kBuffer / kNodeBytes;
+const std::size_t kMaxLive = 1000;
+
+volatile long long sink;
+
+template<typename List>
+double churn(List& items) {
+    std::mt19937 rng(42);
+    long long sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < kOperations; ++i) {
+        unsigned roll = rng();
+        if (items.size() == 0 || (items.size() < kMaxLive && roll % 2 == 0)) {
+            if (roll & 2) {
+                items.push_back(static_cast<int>(i));
+            } else {
+                items.push_front(static_cast<int>(i));
+            }
+        } else {
+            sum += roll & 2 ? *items.rbegin() : *items.begin();
+            if (roll & 4) {
+                items.pop_back();
+            } else {
+                items.pop_front();
+            }
+        }
+    }
+    sink = sum;
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+template<template<typename, typename> typename List>
+void compare(const char* name) {
+    List<int, std::allocator<int>> plain;
+    double plain_ms = churn(plain);
+
+    auto storage = std::make_unique<stack_storage<kBuffer>>(std::pmr::null_memory_resource());
+    List<int, stack_allocator<int, kBuffer>> stacked{stack_allocator<int, kBuffer>(*storage)};
+    double stacked_ms = churn(stacked);
+
+    std::cout << "  " << name << ": std::allocator " << plain_ms << " ms, stack_allocator " << stacked_ms << " ms\n";
+}
+}
+
+int main() {
+    std::cout << kOperations << " random push/pop operations, at most " << kMaxLive << " live nodes, "
+              << kBuffer << "-byte buffer\n";
+    compare<std::list>("std::list");
+    compare<list>("list     ");
+}
@@ -0,0 +1,71 @@
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <vector>
+
+#include "list.hpp"
+#include "pool_allocator.hpp"
+#include "stack_allocator.hpp"
+
+// Random insert/erase in the middle of a list of about kLive nodes: each
+// step inserts next to a random live node or erases one. Iterators to the
+// live nodes are kept in a vector so positions cost O(1). The same list on
+// std::allocator, the bump stack_allocator and pool_allocator.
+namespace {
+const std::size_t kLive = 100'000;
+const std::size_t kSteps = 5'000'000;
+const std::size_t kBuffer = 16 * 1024 * 1024;
+
+volatile long long sink;
+
+template<typename List>
+double churn(List& items) {
+    std::mt19937 rng(7);
+    std::vector<typename List::iterator> live;
+    long long sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < kLive; ++i) {
+        live.push_back(items.insert(items.end(), static_cast<int>(i)));
+    }
+    for (std::size_t step = 0; step < kSteps; ++step) {
+        std::size_t at = rng() % live.size();
+        if (rng() % 2 == 0) {
+            live.push_back(items.insert(live[at], static_cast<int>(step)));
+        } else {
+            sum += *live[at];
+            items.erase(live[at]);
+            live[at] = live.back();
+            live.pop_back();
+        }
+    }
+    sink = sum;
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+template<template<typename, typename> typename List>
+void compare(const char* name) {
+    List<int, std::allocator<int>> plain;
+    double plain_ms = churn(plain);
+
+    auto storage = std::make_unique<stack_storage<kBuffer>>();
+    List<int, stack_allocator<int, kBuffer>> stacked{stack_allocator<int, kBuffer>(*storage)};
+    double stacked_ms = churn(stacked);
+
+    node_pool<> pool;
+    List<int, pool_allocator<int>> pooled{pool_allocator<int>(pool)};
+    double pooled_ms = churn(pooled);
+
+    std::cout << "  " << name << ": std::allocator " << plain_ms << " ms, stack_allocator " << stacked_ms
+              << " ms, pool_allocator " << pooled_ms << " ms\n";
+}
+}
+
+int main() {
+    std::cout << kSteps << " random inserts/erases around " << kLive << " live nodes\n";
+    compare<std::list>("std::list");
+    compare<list>("list     ");
+}
@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <random>
+#include <vector>
+
+#include "list.hpp"
+
+// Sorting a list of random ints in place: list::sort, std::list::sort, and
+// the old workaround of copying into a std::vector, sorting that and
+// writing the values back. The node count defaults to 10M and can be
+// given as the first argument.
+namespace {
+template<typename Sort>
+double time_ms(Sort sort) {
+    auto start = std::chrono::steady_clock::now();
+    sort();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+template<typename List>
+List random_list(std::size_t size) {
+    std::mt19937 rng(11);
+    List items;
+    for (std::size_t i = 0; i < size; ++i) {
+        items.push_back(static_cast<int>(rng()));
+    }
+    return items;
+}
+
+template<typename List>
+bool sorted(const List& items) {
+    return std::is_sorted(items.begin(), items.end());
+}
+}
+
+int main(int argc, char** argv) {
+    std::size_t size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+    std::cout << "sorting " << size << " nodes\n";
+    {
+        auto items = random_list<list<int>>(size);
+        std::cout << "  list::sort            " << time_ms([&] { items.sort(); }) << " ms";
+        std::cout << (sorted(items) ? "\n" : " (NOT SORTED)\n");
+    }
+    {
+        auto items = random_list<std::list<int>>(size);
+        std::cout << "  std::list::sort       " << time_ms([&] { items.sort(); }) << " ms";
+        std::cout << (sorted(items) ? "\n" : " (NOT SORTED)\n");
+    }
+    {
+        auto items = random_list<list<int>>(size);
+        std::cout << "  copy to vector + sort " << time_ms([&] {
+            std::vector<int> values(items.begin(), items.end());
+            std::sort(values.begin(), values.end());
+            std::copy(values.begin(), values.end(), items.begin());
+        }) << " ms";
+        std::cout << (sorted(items) ? "\n" : " (NOT SORTED)\n");
+    }
+}
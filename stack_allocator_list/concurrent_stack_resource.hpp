@@ -0,0 +1,304 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Bump-only stack_resource that any number of threads may allocate from at
+// once. Deallocation is a no-op and memory comes back when the resource dies,
+// so it suits short-lived shared arenas: one request, one frame, one batch.
+template <std::size_t N>
+class atomic_stack_resource : public std::pmr::memory_resource {
+public:
+    explicit atomic_stack_resource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : buff(), offset(0), upstream(upstream), overflow(nullptr) {}
+
+    atomic_stack_resource(const atomic_stack_resource&) = delete;
+
+    atomic_stack_resource& operator=(const atomic_stack_resource&) = delete;
+
+    ~atomic_stack_resource() {
+        overflow_block* block = overflow.load(std::memory_order_acquire);
+        while (block != nullptr) {
+            overflow_block* prev = block->prev;
+            upstream->deallocate(block, block->size, block->alignment);
+            block = prev;
+        }
+    }
+
+private:
+    struct overflow_block {
+        overflow_block* prev;
+        std::size_t size;
+        std::size_t alignment;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        std::uintptr_t base = reinterpret_cast<std::uintptr_t>(buff);
+        std::size_t old = offset.load(std::memory_order_relaxed);
+        while (true) {
+            std::size_t start = ((base + old + alignment - 1) & ~(alignment - 1)) - base;
+            if (start > N || bytes > N - start) {
+                return allocate_overflow(bytes, alignment);
+            }
+            if (offset.compare_exchange_weak(old, start + bytes, std::memory_order_relaxed)) {
+                return buff + start;
+            }
+        }
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    // Past the buffer every request is its own upstream block, chained for
+    // release on destruction.
+    void* allocate_overflow(std::size_t bytes, std::size_t alignment) {
+        if (alignment < alignof(overflow_block)) {
+            alignment = alignof(overflow_block);
+        }
+        std::size_t header = (sizeof(overflow_block) + alignment - 1) & ~(alignment - 1);
+        void* memory = upstream->allocate(header + bytes, alignment);
+        overflow_block* block = new (memory) overflow_block{overflow.load(std::memory_order_relaxed)
+                                                           , header + bytes, alignment};
+        while (!overflow.compare_exchange_weak(block->prev, block
+                                               , std::memory_order_release, std::memory_order_relaxed)) {}
+        return static_cast<char*>(memory) + header;
+    }
+
+    alignas(std::max_align_t) char buff[N];
+    std::atomic<std::size_t> offset;
+    std::pmr::memory_resource* upstream;
+    std::atomic<overflow_block*> overflow;
+};
+
+// Thread-caching resource: every thread bump-allocates from its own slabs and
+// recycles through its own size-class free lists, without atomics. A chunk
+// freed by another thread is pushed onto its owner's lock-free remote list,
+// which the owner drains when a local list runs dry. Slabs are SlabSize-aligned
+// so a chunk finds its owner by masking its address.
+//
+// Requests above max_small_size or aligned above granule go straight upstream,
+// which must then be thread-safe. A thread's heap outlives the thread: on exit
+// the thread gives it up, and the next thread needing a heap adopts it along
+// with the frees queued on it meanwhile. All memory goes back upstream when
+// the resource dies.
+template <std::size_t SlabSize = 64 * 1024>
+class thread_stack_resource : public std::pmr::memory_resource {
+public:
+    explicit thread_stack_resource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : id(next_id.fetch_add(1, std::memory_order_relaxed) + 1), upstream(upstream)
+        , life(std::make_shared<lifetime>()), heaps(nullptr) {}
+
+    thread_stack_resource(const thread_stack_resource&) = delete;
+
+    thread_stack_resource& operator=(const thread_stack_resource&) = delete;
+
+    ~thread_stack_resource() {
+        {
+            std::lock_guard<std::mutex> guard(life->lock);
+            life->alive = false;
+        }
+        heap* current = heaps.load(std::memory_order_acquire);
+        while (current != nullptr) {
+            while (current->slabs != nullptr) {
+                slab* prev = current->slabs->prev;
+                upstream->deallocate(current->slabs, SlabSize, SlabSize);
+                current->slabs = prev;
+            }
+            heap* next = current->next;
+            delete current;
+            current = next;
+        }
+    }
+
+private:
+    struct free_chunk {
+        free_chunk* next;
+        std::size_t size_class;
+    };
+
+    struct heap;
+
+    struct slab {
+        heap* owner;
+        slab* prev;
+    };
+
+    static constexpr std::size_t granule = sizeof(free_chunk);
+    static constexpr std::size_t max_small_size = 1024;
+    static constexpr std::size_t class_count = max_small_size / granule;
+    static constexpr std::size_t cache_line = 64;
+
+    static_assert(std::has_single_bit(SlabSize) && SlabSize >= 8 * max_small_size
+                  , "slab size must be a power of two holding several of the largest chunks");
+
+    // owner is the default id while no thread holds the heap.
+    struct alignas(cache_line) heap {
+        std::atomic<std::thread::id> owner;
+        heap* next;
+        char* curr = nullptr;
+        char* end = nullptr;
+        slab* slabs = nullptr;
+        free_chunk* free_lists[class_count] = {};
+        alignas(cache_line) std::atomic<free_chunk*> remote{nullptr};
+    };
+
+    // One entry per thread: a thread switching between resources rescans
+    // the heap list on every switch.
+    struct thread_cache {
+        std::uint64_t resource_id;
+        heap* local;
+    };
+
+    // Shared by a resource and every thread holding one of its heaps, so a
+    // thread exiting after the resource died leaves the freed heap alone.
+    struct lifetime {
+        std::mutex lock;
+        bool alive = true;
+    };
+
+    // Heaps the current thread holds, across resources; given up on exit.
+    struct held_heaps {
+        std::vector<std::pair<std::shared_ptr<lifetime>, heap*>> entries;
+
+        ~held_heaps() {
+            for (auto& [life, held] : entries) {
+                std::lock_guard<std::mutex> guard(life->lock);
+                if (life->alive) {
+                    held->owner.store(std::thread::id(), std::memory_order_release);
+                }
+            }
+        }
+
+        void add(std::shared_ptr<lifetime> life, heap* held) {
+            std::erase_if(entries, [](auto& entry) {
+                std::lock_guard<std::mutex> guard(entry.first->lock);
+                return !entry.first->alive;
+            });
+            entries.emplace_back(std::move(life), held);
+        }
+    };
+
+    static std::size_t size_class(std::size_t bytes) {
+        return bytes == 0 ? 0 : (bytes - 1) / granule;
+    }
+
+    static bool is_small(std::size_t bytes, std::size_t alignment) {
+        return bytes <= max_small_size && alignment <= granule;
+    }
+
+    static slab* slab_of(void* ptr) {
+        return reinterpret_cast<slab*>(reinterpret_cast<std::uintptr_t>(ptr) & ~(SlabSize - 1));
+    }
+
+    heap* local_heap() {
+        if (cache.resource_id == id) {
+            return cache.local;
+        }
+        std::thread::id self = std::this_thread::get_id();
+        heap* found = heaps.load(std::memory_order_acquire);
+        while (found != nullptr && found->owner.load(std::memory_order_relaxed) != self) {
+            found = found->next;
+        }
+        if (found == nullptr) {
+            found = adopt_or_create(self);
+            held.add(life, found);
+        }
+        cache = thread_cache{id, found};
+        return found;
+    }
+
+    heap* adopt_or_create(std::thread::id self) {
+        for (heap* orphan = heaps.load(std::memory_order_acquire); orphan != nullptr; orphan = orphan->next) {
+            std::thread::id nobody;
+            if (orphan->owner.load(std::memory_order_relaxed) == nobody
+                && orphan->owner.compare_exchange_strong(nobody, self, std::memory_order_acquire)) {
+                drain_remote(orphan);
+                return orphan;
+            }
+        }
+        heap* fresh = new heap{self, heaps.load(std::memory_order_relaxed)};
+        while (!heaps.compare_exchange_weak(fresh->next, fresh
+                                            , std::memory_order_release, std::memory_order_relaxed)) {}
+        return fresh;
+    }
+
+    void drain_remote(heap* local) {
+        free_chunk* chunk = local->remote.exchange(nullptr, std::memory_order_acquire);
+        while (chunk != nullptr) {
+            free_chunk* next = chunk->next;
+            chunk->next = local->free_lists[chunk->size_class];
+            local->free_lists[chunk->size_class] = chunk;
+            chunk = next;
+        }
+    }
+
+    void new_slab(heap* local) {
+        slab* fresh = new (upstream->allocate(SlabSize, SlabSize)) slab{local, local->slabs};
+        local->slabs = fresh;
+        local->curr = reinterpret_cast<char*>(fresh) + granule;
+        local->end = reinterpret_cast<char*>(fresh) + SlabSize;
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (!is_small(bytes, alignment)) {
+            return upstream->allocate(bytes, alignment);
+        }
+        heap* local = local_heap();
+        std::size_t index = size_class(bytes);
+        if (local->free_lists[index] == nullptr && local->remote.load(std::memory_order_relaxed) != nullptr) {
+            drain_remote(local);
+        }
+        if (free_chunk* chunk = local->free_lists[index]) {
+            local->free_lists[index] = chunk->next;
+            return chunk;
+        }
+        std::size_t amount = (index + 1) * granule;
+        if (amount > static_cast<std::size_t>(local->end - local->curr)) {
+            new_slab(local);
+        }
+        local->curr += amount;
+        return local->curr - amount;
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+        if (!is_small(bytes, alignment)) {
+            upstream->deallocate(ptr, bytes, alignment);
+            return;
+        }
+        heap* owner = slab_of(ptr)->owner;
+        free_chunk* chunk = new (ptr) free_chunk{nullptr, size_class(bytes)};
+        if (cache.resource_id == id && cache.local == owner) {
+            chunk->next = owner->free_lists[chunk->size_class];
+            owner->free_lists[chunk->size_class] = chunk;
+            return;
+        }
+        chunk->next = owner->remote.load(std::memory_order_relaxed);
+        while (!owner->remote.compare_exchange_weak(chunk->next, chunk
+                                                    , std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    static inline std::atomic<std::uint64_t> next_id{0};
+    static inline thread_local thread_cache cache{0, nullptr};
+    static inline thread_local held_heaps held;
+
+    const std::uint64_t id;
+    std::pmr::memory_resource* upstream;
+    std::shared_ptr<lifetime> life;
+    std::atomic<heap*> heaps;
+};
@@ -1,15 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
 #include <memory>
-#include <list>
+#include <type_traits>
+#include <utility>
 
 template <typename T, typename Allocator = std::allocator<T>>
 class list {
 private:
+    struct BaseNode;
     struct Node;
 
-    using node_allocator = typename 
+    template <bool IsConst>
+    class based_iterator;
+
+    using node_allocator = typename
     std::allocator_traits<Allocator>::template
     rebind_alloc<Node>;
-    
+
+    using NodeTraits = std::allocator_traits<node_allocator>;
+
 public:
     using value_type = T;
     using allocator_type = Allocator;
@@ -26,8 +38,8 @@ public:
     using reverse_iterator = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-    explicit list() : dummy_head(BaseNode()), sz(0), alloc() {
-        link_nodes(&head, &head);
+    explicit list() : dummy_head(), sz(0), alloc() {
+        link_nodes(&dummy_head, &dummy_head);
     }
 
     explicit list(size_type size): list() {
@@ -38,8 +50,8 @@ public:
         spawn_with_example(size, data);
     }
 
-    explicit list(const allocator_type& alloc) : dummy_head(BaseNode()), sz(0), alloc(alloc) {
-        link_nodes(&head, &head);
+    explicit list(const allocator_type& alloc) : dummy_head(), sz(0), alloc(alloc) {
+        link_nodes(&dummy_head, &dummy_head);
     }
 
     explicit list(size_type size, const allocator_type& alloc) : list(alloc) {
@@ -51,101 +63,309 @@ public:
         spawn_with_example(size, data);
     }
 
+    list(const list& other)
+        : list(allocator_type(NodeTraits::select_on_container_copy_construction(other.alloc))) {
+        link_chain(&dummy_head, build_chain(other.begin(), other.end()));
+    }
+
+    list(const list& other, const allocator_type& alloc) : list(alloc) {
+        link_chain(&dummy_head, build_chain(other.begin(), other.end()));
+    }
+
     ~list() {
         this->clear();
     }
 
+    list& operator=(const list& other) {
+        if (&other == this) {
+            return *this;
+        }
+
+        if (NodeTraits::propagate_on_container_copy_assignment::value) {
+            list copy(other, allocator_type(other.alloc));
+            swap_nodes(copy);
+            std::swap(alloc, copy.alloc);
+        } else {
+            list copy(other, allocator_type(alloc));
+            swap_nodes(copy);
+        }
+
+        return *this;
+    }
+
+    allocator_type get_allocator() const {
+        return allocator_type(alloc);
+    }
+
+    size_type size() const {
+        return sz;
+    }
+
+    bool empty() const {
+        return sz == 0;
+    }
+
+    iterator begin() {
+        return iterator(dummy_head.next);
+    }
+
+    const_iterator begin() const {
+        return cbegin();
+    }
+
+    const_iterator cbegin() const {
+        return const_iterator(dummy_head.next);
+    }
+
+    iterator end() {
+        return iterator(&dummy_head);
+    }
+
+    const_iterator end() const {
+        return cend();
+    }
+
+    const_iterator cend() const {
+        return const_iterator(const_cast<BaseNode*>(&dummy_head));
+    }
+
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const {
+        return crbegin();
+    }
+
+    const_reverse_iterator crbegin() const {
+        return const_reverse_iterator(cend());
+    }
+
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const {
+        return crend();
+    }
+
+    const_reverse_iterator crend() const {
+        return const_reverse_iterator(cbegin());
+    }
+
     void clear() {
         BaseNode* cur = dummy_head.next;
         while (cur != &dummy_head) {
             cur = cur->next;
-            std::allocator_traits<node_allocator>::destroy(alloc, static_cast<Node*>(cur->prev));
-            std::allocator_traits<node_allocator>::deallocate(alloc, static_cast<Node*>(cur->prev), 1);
+            destroy_node(cur->prev);
         }
+        link_nodes(&dummy_head, &dummy_head);
         sz = 0;
     }
 
     void push_back(const_reference data) {
-        try {
-            Node* temp = std::allocator_traits<node_allocator>::allocate(alloc, 1);
-            std::allocator_traits<node_allocator>::construct(alloc, temp, data);
-            link_nodes(dummy_head.prev, temp);
-            link_nodes(temp, &dummy_head);
-            ++sz;
-        } catch  (...) {
-            throw;
-        }
+        insert(cend(), data);
     }
 
     void push_front(const_reference data) {
-        try {
-            Node* temp = std::allocator_traits<node_allocator>::allocate(alloc, 1);
-            std::allocator_traits<node_allocator>::construct(alloc, temp, data);
-            link_nodes(temp, dummy_head.next);
-            link_nodes(&dummy_head, temp);
-            ++sz;
-        } catch  (...) {
-            throw;
-        }
+        insert(cbegin(), data);
     }
 
     void pop_front() {
-        BaseNode* next = dummy_head.next->next;
-        NodeTraits::destroy(allocator, static_cast<Node*>(dummy_head.next));
-        NodeTraits::deallocate(allocator, static_cast<Node*>(dummy_head.next), 1);
-        link_nodes(&dummy_head, next);
-        --sz;
+        erase(cbegin());
     }
 
     void pop_back() {
-        BaseNode* prev = dummy_head.prev->prev;
-        NodeTraits::destroy(allocator, static_cast<Node*>(dummy_head.prev));
-        NodeTraits::deallocate(allocator, static_cast<Node*>(dummy_head.prev), 1);
-        link_nodes(prev, &dummy_head);
+        erase(std::prev(cend()));
+    }
+
+    iterator insert(const_iterator pos, const_reference data) {
+        Node* temp = create_node(data);
+        link_nodes(pos.node->prev, temp);
+        link_nodes(temp, pos.node);
+        ++sz;
+        return iterator(temp);
+    }
+
+    // Range inserts build the new nodes off to the side and link them in
+    // only once every copy has succeeded.
+    iterator insert(const_iterator pos, size_type count, const_reference data) {
+        chain built = build_chain([&](chain& out) {
+            for (size_type i = 0; i < count; ++i) {
+                append_node(out, data);
+            }
+        });
+        return link_chain(pos.node, built);
+    }
+
+    template <std::input_iterator InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last) {
+        return link_chain(pos.node, build_chain(first, last));
+    }
+
+    iterator erase(const_iterator pos) {
+        BaseNode* next = pos.node->next;
+        link_nodes(pos.node->prev, next);
+        destroy_node(pos.node);
         --sz;
+        return iterator(next);
     }
 
-    list& operator=(const list& other) {
-        if (&other == this) {
-            return *this;
+    iterator erase(const_iterator first, const_iterator last) {
+        while (first != last) {
+            first = erase(first);
         }
+        return iterator(last.node);
+    }
 
-        BaseNode* ne = dummy_head.next;
-        BaseNode* prev = dummy_head.prev;
-        size_type saved = sz;
-        link_nodes(&dummy_head, &dummy_head);
-        
+    // Splicing relinks nodes, so other must use an equal allocator. Moving a
+    // range out of another list costs its length, to keep size() O(1).
+    void splice(const_iterator pos, list& other) {
+        if (&other == this || other.empty()) {
+            return;
+        }
+        size_type count = other.sz;
+        transfer(pos.node, other.dummy_head.next, &other.dummy_head);
+        sz += count;
+        other.sz = 0;
+    }
+
+    void splice(const_iterator pos, list&& other) {
+        splice(pos, other);
+    }
+
+    void splice(const_iterator pos, list& other, const_iterator it) {
+        transfer(pos.node, it.node, it.node->next);
+        ++sz;
+        --other.sz;
+    }
+
+    void splice(const_iterator pos, list&& other, const_iterator it) {
+        splice(pos, other, it);
+    }
+
+    void splice(const_iterator pos, list& other, const_iterator first, const_iterator last) {
+        if (first == last) {
+            return;
+        }
+        if (&other != this) {
+            size_type count = std::distance(first, last);
+            sz += count;
+            other.sz -= count;
+        }
+        transfer(pos.node, first.node, last.node);
+    }
+
+    void splice(const_iterator pos, list&& other, const_iterator first, const_iterator last) {
+        splice(pos, other, first, last);
+    }
+
+    // Stable. Nodes are merged through next links only, so if comp throws
+    // both lists are rebuilt from their untouched prev links, as they were.
+    template <typename Compare>
+    void merge(list& other, Compare comp) {
+        if (&other == this || other.empty()) {
+            return;
+        }
+        BaseNode* last = dummy_head.prev;
+        BaseNode* other_last = other.dummy_head.prev;
+        BaseNode* mine = detach_run();
+        BaseNode* theirs = other.detach_run();
+        BaseNode* merged;
         try {
-            using NodeTraits = std::allocator_traits<node_allocator>;
-            
-            if (NodeTraits::propagate_on_container_copy_assignment::value) {
-                node_allocator buf = other.alloc;
-                spawn_from_other(other, buf);
-            } else {
-                spawn_from_other(other, alloc);
-            }
+            merged = merge_runs(mine, theirs, comp);
+        } catch (...) {
+            restore_order(last);
+            other.restore_order(other_last);
+            throw;
+        }
+        relink_runs(merged);
+        sz += other.sz;
+        other.sz = 0;
+    }
 
-            std::swap(ne, dummy_head.next);
-            std::swap(prev, dummy_head.prev);
+    template <typename Compare>
+    void merge(list&& other, Compare comp) {
+        merge(other, comp);
+    }
+
+    void merge(list& other) {
+        merge(other, std::less<>());
+    }
 
-            clear();
+    void merge(list&& other) {
+        merge(other, std::less<>());
+    }
 
-            dummy_head.next = ne;
-            dummy_head.prev = prev;
-            sz = other.sz;
-            if (NodeTraits::propagate_on_container_copy_assignment::value) {
-                alloc = other.alloc;
+    // Stable bottom-up merge sort that relinks nodes and never copies,
+    // moves or allocates. Runs are linked through next only; if comp throws,
+    // the list is rebuilt from the untouched prev links in its old order.
+    template <typename Compare>
+    void sort(Compare comp) {
+        if (sz < 2) {
+            return;
+        }
+        BaseNode* last = dummy_head.prev;
+        BaseNode* rest = detach_run();
+
+        // bins[i] holds a sorted run of 2^i nodes taken before any in carry.
+        BaseNode* bins[64] = {};
+        BaseNode* carry = nullptr;
+        try {
+            while (rest != nullptr) {
+                carry = rest;
+                rest = rest->next;
+                carry->next = nullptr;
+                size_type i = 0;
+                for (; bins[i] != nullptr; ++i) {
+                    carry = merge_runs(std::exchange(bins[i], nullptr), carry, comp);
+                }
+                bins[i] = std::exchange(carry, nullptr);
+            }
+            for (BaseNode*& bin : bins) {
+                if (bin != nullptr) {
+                    carry = merge_runs(std::exchange(bin, nullptr), carry, comp);
+                }
             }
         } catch (...) {
-            dummy_head.next = ne;
-            dummy_head.prev = prev;
-            sz = saved;
+            restore_order(last);
             throw;
         }
+        relink_runs(carry);
+    }
 
-        return *this;
+    void sort() {
+        sort(std::less<>());
+    }
+
+    // unique and remove_if give the strong guarantee: removed nodes are
+    // parked and only destroyed once the predicate can no longer throw.
+    template <typename BinaryPredicate>
+    size_type unique(BinaryPredicate pred) {
+        if (sz < 2) {
+            return 0;
+        }
+        return remove_nodes([&](BaseNode* node) {
+            return node->prev != &dummy_head && pred(data_of(node->prev), data_of(node));
+        });
+    }
+
+    size_type unique() {
+        return unique(std::equal_to<>());
+    }
+
+    template <typename UnaryPredicate>
+    size_type remove_if(UnaryPredicate pred) {
+        return remove_nodes([&](BaseNode* node) {
+            return pred(data_of(node));
+        });
     }
 
+    size_type remove(const_reference data) {
+        return remove_if([&](const_reference other) {
+            return other == data;
+        });
+    }
 
 private:
     struct BaseNode {
@@ -156,24 +376,29 @@ private:
     struct Node : BaseNode {
         value_type data;
 
-        explicit Node(const_reference data) : data(data) {}
-
-        explicit Node() : data() {}
+        template <typename... Args>
+        explicit Node(Args&&... args) : data(std::forward<Args>(args)...) {}
     };
 
     template <bool IsConst>
     class based_iterator {
     public:
-        using value_type = typename std::conditional<IsConst, const T, T>::type;
+        using value_type = T;
         using difference_type = std::ptrdiff_t;
         using iterator_category = std::bidirectional_iterator_tag;
-        using reference = value_type&;
-        using pointer = value_type*;
+        using reference = typename std::conditional<IsConst, const T&, T&>::type;
+        using pointer = typename std::conditional<IsConst, const T*, T*>::type;
 
-        explicit based_iterator(const based_iterator&) = default;
+        based_iterator() : node(nullptr) {}
+
+        based_iterator(const based_iterator&) = default;
 
         based_iterator& operator=(const based_iterator&) = default;
 
+        operator based_iterator<true>() const requires (!IsConst) {
+            return based_iterator<true>(node);
+        }
+
         bool operator==(const based_iterator& other) const {
             return node == other.node;
         }
@@ -182,94 +407,256 @@ private:
             return node != other.node;
         }
 
-        reference operator*() {
+        reference operator*() const {
             return static_cast<Node*>(node)->data;
         }
 
-        const T& operator*() const {
-            return static_cast<Node*>(node)->data;
+        pointer operator->() const {
+            return &(static_cast<Node*>(node)->data);
         }
 
-        pointer operator->() {
-            return &(static_cast<Node*>(node)->data);
+        based_iterator& operator++() {
+            node = node->next;
+            return *this;
         }
 
-        const T* operator->() const {
-            return &(static_cast<Node*>(node)->data);
+        based_iterator operator++(int) {
+            based_iterator copy = *this;
+            node = node->next;
+            return copy;
         }
-    
-    private: 
+
+        based_iterator& operator--() {
+            node = node->prev;
+            return *this;
+        }
+
+        based_iterator operator--(int) {
+            based_iterator copy = *this;
+            node = node->prev;
+            return copy;
+        }
+
+    private:
+        friend class list;
+
+        template <bool>
+        friend class based_iterator;
+
         BaseNode* node;
 
         explicit based_iterator(BaseNode* node) : node(node) {}
     };
 
+    // A detached run of nodes linked through next/prev; first is null when
+    // the run is empty.
+    struct chain {
+        BaseNode* first = nullptr;
+        BaseNode* last = nullptr;
+        size_type count = 0;
+    };
+
+    static const_reference data_of(const BaseNode* node) {
+        return static_cast<const Node*>(node)->data;
+    }
+
     void link_nodes(BaseNode* left, BaseNode* right) {
         left->next = right;
         right->prev = left;
     }
 
-    void spawn(size_type count) {
-        if (count == 0) {
-            return;
+    template <typename... Args>
+    Node* create_node(Args&&... args) {
+        Node* node = NodeTraits::allocate(alloc, 1);
+        try {
+            NodeTraits::construct(alloc, node, std::forward<Args>(args)...);
+        } catch (...) {
+            NodeTraits::deallocate(alloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void destroy_node(BaseNode* node) {
+        NodeTraits::destroy(alloc, static_cast<Node*>(node));
+        NodeTraits::deallocate(alloc, static_cast<Node*>(node), 1);
+    }
+
+    template <typename... Args>
+    void append_node(chain& out, Args&&... args) {
+        Node* node = create_node(std::forward<Args>(args)...);
+        if (out.first == nullptr) {
+            out.first = node;
+        } else {
+            link_nodes(out.last, node);
         }
+        out.last = node;
+        ++out.count;
+    }
 
-        BaseNode* last = &head;
-        Node* node_p = nullptr;
-        size_type start = 0;
+    // Runs fill(out); if it throws, every node built so far is destroyed.
+    template <typename Fill>
+    chain build_chain(Fill fill) {
+        chain out;
         try {
-            for (; start < count; ++start) {
-                Node* cur = std::allocator_traits<node_allocator>::allocate(alloc, 1);
-                std::allocator_traits<node_allocator>::construct(alloc, cur);
-                link_nodes(last, cur);
-                last = cur;
-            }
+            fill(out);
         } catch (...) {
-            for (size_type j = 0; j < start) {
-                Node* prev = last->prev;
-                std::allocator_traits<node_allocator>::destroy(alloc, last);
-                std::allocator_traits<node_allocator>::deallocate(alloc, last);
-                last = static_cast<Node*>(prev);
+            while (out.count != 0) {
+                BaseNode* prev = out.last->prev;
+                destroy_node(out.last);
+                out.last = prev;
+                --out.count;
             }
             throw;
         }
+        return out;
+    }
+
+    template <typename InputIt>
+    chain build_chain(InputIt first, InputIt last) {
+        return build_chain([&](chain& out) {
+            for (; first != last; ++first) {
+                append_node(out, *first);
+            }
+        });
+    }
 
-        this->sz = count;
+    iterator link_chain(BaseNode* pos, const chain& built) {
+        if (built.count == 0) {
+            return iterator(pos);
+        }
+        link_nodes(pos->prev, built.first);
+        link_nodes(built.last, pos);
+        sz += built.count;
+        return iterator(built.first);
+    }
+
+    void spawn(size_type count) {
+        link_chain(&dummy_head, build_chain([&](chain& out) {
+            for (size_type i = 0; i < count; ++i) {
+                append_node(out);
+            }
+        }));
     }
 
     void spawn_with_example(size_type count, const_reference data) {
-        if (count == 0) {
+        link_chain(&dummy_head, build_chain([&](chain& out) {
+            for (size_type i = 0; i < count; ++i) {
+                append_node(out, data);
+            }
+        }));
+    }
+
+    // Swaps the node chains and sizes, leaving the allocators alone.
+    void swap_nodes(list& other) {
+        std::swap(dummy_head.next, other.dummy_head.next);
+        std::swap(dummy_head.prev, other.dummy_head.prev);
+        std::swap(sz, other.sz);
+        for (list* side : {this, &other}) {
+            if (side->sz == 0) {
+                link_nodes(&side->dummy_head, &side->dummy_head);
+            } else {
+                link_nodes(&side->dummy_head, side->dummy_head.next);
+                link_nodes(side->dummy_head.prev, &side->dummy_head);
+            }
+        }
+    }
+
+    // Moves [first, last) in front of pos; pos must not lie inside the range.
+    void transfer(BaseNode* pos, BaseNode* first, BaseNode* last) {
+        if (pos == first || pos == last) {
             return;
         }
+        BaseNode* tail = last->prev;
+        link_nodes(first->prev, last);
+        link_nodes(pos->prev, first);
+        link_nodes(tail, pos);
+    }
+
+    // Empties the list into a null-terminated run linked through next; every
+    // node keeps its prev link, which restore_order relies on.
+    BaseNode* detach_run() {
+        BaseNode* run = dummy_head.next;
+        dummy_head.prev->next = nullptr;
+        link_nodes(&dummy_head, &dummy_head);
+        return run == &dummy_head ? nullptr : run;
+    }
 
-        BaseNode* last = &head;
-        Node* node_p = nullptr;
-        size_type start = 0;
+    // Undoes detach_run, given the old last node, by walking the prev links.
+    void restore_order(BaseNode* last) {
+        BaseNode* after = &dummy_head;
+        dummy_head.prev = last;
+        for (BaseNode* cur = last; cur != &dummy_head; cur = cur->prev) {
+            cur->next = after;
+            after = cur;
+        }
+        dummy_head.next = after;
+    }
+
+    // Merges two null-terminated runs linked through next only, preferring
+    // first on ties. Leaves every prev link alone.
+    template <typename Compare>
+    static BaseNode* merge_runs(BaseNode* first, BaseNode* second, Compare& comp) {
+        BaseNode* head = nullptr;
+        BaseNode** tail = &head;
+        while (first != nullptr && second != nullptr) {
+            BaseNode*& taken = comp(data_of(second), data_of(first)) ? second : first;
+            *tail = taken;
+            tail = &taken->next;
+            taken = taken->next;
+        }
+        *tail = first != nullptr ? first : second;
+        return head;
+    }
+
+    // Appends a null-terminated run to the back of the list, restoring prev.
+    void relink_runs(BaseNode* run) {
+        while (run != nullptr) {
+            BaseNode* next = run->next;
+            link_nodes(dummy_head.prev, run);
+            link_nodes(run, &dummy_head);
+            run = next;
+        }
+    }
+
+    // Unlinks every node matching doomed. A parked node keeps prev pointing
+    // at its neighbour at removal time, so putting them back in reverse order
+    // restores the list exactly.
+    template <typename Doomed>
+    size_type remove_nodes(Doomed doomed) {
+        BaseNode* parked = nullptr;
+        size_type count = 0;
         try {
-            for (; start < count; ++start) {
-                Node* cur = std::allocator_traits<node_allocator>::allocate(alloc, 1);
-                std::allocator_traits<node_allocator>::construct(alloc, cur, data);
-                link_nodes(last, cur);
-                last = cur;
+            BaseNode* cur = dummy_head.next;
+            while (cur != &dummy_head) {
+                BaseNode* next = cur->next;
+                if (doomed(cur)) {
+                    link_nodes(cur->prev, next);
+                    cur->next = parked;
+                    parked = cur;
+                    ++count;
+                }
+                cur = next;
             }
         } catch (...) {
-            for (size_type j = 0; j < start) {
-                Node* prev = last->prev;
-                std::allocator_traits<node_allocator>::destroy(alloc, last);
-                std::allocator_traits<node_allocator>::deallocate(alloc, last);
-                last = static_cast<Node*>(prev);
+            while (parked != nullptr) {
+                BaseNode* next = parked->next;
+                link_nodes(parked, parked->prev->next);
+                link_nodes(parked->prev, parked);
+                parked = next;
             }
             throw;
         }
-
-        this->sz = count;
+        while (parked != nullptr) {
+            BaseNode* next = parked->next;
+            destroy_node(parked);
+            parked = next;
+        }
+        sz -= count;
+        return count;
     }
 
-    void spawn_from_other(const list& list, node_allocator&) {
-
-    }
-    
     BaseNode dummy_head;
     size_type sz;
     [[ no_unique_address ]] node_allocator alloc;
-};
\ No newline at end of file
+};
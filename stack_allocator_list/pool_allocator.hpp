@@ -0,0 +1,245 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+// Owner of the slabs behind pool_allocator. Each node stride gets its own
+// fixed_pool, so a container and all its rebound allocators share one
+// node_pool whatever their node types. Like stack_storage, it is not
+// thread-safe.
+template <std::size_t NodesPerSlab = 64>
+class node_pool {
+public:
+    // With return_empty_slabs, a slab whose last node is freed goes back
+    // upstream unless it is the only one left with free nodes.
+    explicit node_pool(bool return_empty_slabs = false
+                       , std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream(upstream), return_empty_slabs(return_empty_slabs), pools() {}
+
+    node_pool(const node_pool&) = delete;
+
+    node_pool& operator=(const node_pool&) = delete;
+
+    template <typename T, std::size_t M>
+    friend class pool_allocator;
+
+private:
+    // Slabs are power-of-two sized and aligned, so a node finds its slab by
+    // masking its address. The header fills the first cache line and nodes
+    // up to half a line are padded to a power of two, so none of them
+    // straddles two lines; larger ones are left unpadded to save footprint.
+    // Allocation always comes from the first partial slab.
+    class fixed_pool {
+    public:
+        fixed_pool(std::size_t stride, std::size_t alignment, std::pmr::memory_resource* upstream
+                   , bool return_empty_slabs)
+            : stride(stride), alignment(alignment)
+            , first_node(alignment > cache_line ? alignment : cache_line)
+            , slab_size(std::bit_ceil(first_node + NodesPerSlab * stride))
+            , upstream(upstream), return_empty_slabs(return_empty_slabs), partial(nullptr), full(nullptr) {}
+
+        fixed_pool(const fixed_pool&) = delete;
+
+        fixed_pool& operator=(const fixed_pool&) = delete;
+
+        ~fixed_pool() {
+            for (slab* list : {partial, full}) {
+                while (list != nullptr) {
+                    slab* next = list->next;
+                    upstream->deallocate(list, slab_size, slab_size);
+                    list = next;
+                }
+            }
+        }
+
+        static std::size_t stride_for(std::size_t size, std::size_t alignment) {
+            std::size_t stride = size < sizeof(free_node) ? sizeof(free_node) : size;
+            if (alignment < alignof(free_node)) {
+                alignment = alignof(free_node);
+            }
+            stride = (stride + alignment - 1) / alignment * alignment;
+            return stride <= cache_line / 2 ? std::bit_ceil(stride) : stride;
+        }
+
+        bool serves(std::size_t other_stride, std::size_t other_alignment) const {
+            return stride == other_stride && alignment >= other_alignment;
+        }
+
+        void* allocate() {
+            slab* current = partial != nullptr ? partial : new_slab();
+            void* node;
+            if (current->free != nullptr) {
+                node = current->free;
+                current->free = current->free->next;
+            } else {
+                node = current->bump;
+                current->bump += stride;
+            }
+            ++current->live;
+            if (is_full(current)) {
+                unlink(partial, current);
+                push_front(full, current);
+            }
+            return node;
+        }
+
+        void deallocate(void* ptr) {
+            slab* owner = slab_of(ptr);
+            bool was_full = is_full(owner);
+            owner->free = new (ptr) free_node{owner->free};
+            --owner->live;
+            if (was_full) {
+                unlink(full, owner);
+                push_front(partial, owner);
+            }
+            if (owner->live == 0 && return_empty_slabs && (owner != partial || owner->next != nullptr)) {
+                unlink(partial, owner);
+                upstream->deallocate(owner, slab_size, slab_size);
+            }
+        }
+
+    private:
+        struct free_node {
+            free_node* next;
+        };
+
+        struct slab {
+            slab* prev;
+            slab* next;
+            free_node* free;
+            char* bump;
+            std::size_t live;
+        };
+
+        static constexpr std::size_t cache_line = 64;
+
+        static_assert(sizeof(slab) <= cache_line);
+
+        bool is_full(const slab* candidate) const {
+            return candidate->free == nullptr
+                && candidate->bump + stride > reinterpret_cast<const char*>(candidate) + slab_size;
+        }
+
+        slab* slab_of(void* ptr) const {
+            return reinterpret_cast<slab*>(reinterpret_cast<std::uintptr_t>(ptr) & ~(slab_size - 1));
+        }
+
+        slab* new_slab() {
+            slab* fresh = static_cast<slab*>(upstream->allocate(slab_size, slab_size));
+            new (fresh) slab{nullptr, nullptr, nullptr, reinterpret_cast<char*>(fresh) + first_node, 0};
+            push_front(partial, fresh);
+            return fresh;
+        }
+
+        static void unlink(slab*& list, slab* target) {
+            (target->prev != nullptr ? target->prev->next : list) = target->next;
+            if (target->next != nullptr) {
+                target->next->prev = target->prev;
+            }
+        }
+
+        static void push_front(slab*& list, slab* target) {
+            target->prev = nullptr;
+            target->next = list;
+            if (list != nullptr) {
+                list->prev = target;
+            }
+            list = target;
+        }
+
+        std::size_t stride;
+        std::size_t alignment;
+        std::size_t first_node;
+        std::size_t slab_size;
+        std::pmr::memory_resource* upstream;
+        bool return_empty_slabs;
+        slab* partial;
+        slab* full;
+    };
+
+    fixed_pool* pool_for(std::size_t size, std::size_t alignment) {
+        std::size_t stride = fixed_pool::stride_for(size, alignment);
+        for (auto& pool : pools) {
+            if (pool->serves(stride, alignment)) {
+                return pool.get();
+            }
+        }
+        pools.push_back(std::make_unique<fixed_pool>(stride, alignment, upstream, return_empty_slabs));
+        return pools.back().get();
+    }
+
+    std::pmr::memory_resource* upstream;
+    bool return_empty_slabs;
+    std::vector<std::unique_ptr<fixed_pool>> pools;
+};
+
+// Node allocator over a node_pool: single-object requests come from the
+// pool, anything larger (bucket arrays, vectors) goes straight upstream.
+// The fixed_pool for T is looked up on the first single-object request, so
+// constructing, copying and rebinding never allocate and never throw.
+template <typename T, std::size_t NodesPerSlab = 64>
+class pool_allocator {
+public:
+    using pointer = T*;
+    using const_pointer = const T*;
+    using void_pointer = void*;
+    using const_void_pointer = const void*;
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    explicit pool_allocator(node_pool<NodesPerSlab>& pool) noexcept : pools(&pool), fixed(nullptr) {}
+
+    template <typename U>
+    pool_allocator(const pool_allocator<U, NodesPerSlab>& other) noexcept : pools(other.pools), fixed(nullptr) {}
+
+    T* allocate(std::size_t count) {
+        if (count == 1) {
+            return static_cast<T*>(fixed_for_t().allocate());
+        }
+        return static_cast<T*>(pools->upstream->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t count) {
+        if (count == 1) {
+            // The pool exists since the node came from it, so this finds it.
+            fixed_for_t().deallocate(ptr);
+        } else {
+            pools->upstream->deallocate(ptr, count * sizeof(T), alignof(T));
+        }
+    }
+
+    template <typename U>
+    bool operator==(const pool_allocator<U, NodesPerSlab>& other) const {
+        return pools == other.pools;
+    }
+
+    template <typename U>
+    bool operator!=(const pool_allocator<U, NodesPerSlab>& other) const {
+        return pools != other.pools;
+    }
+
+    template <typename U>
+    struct rebind {
+        using other = pool_allocator<U, NodesPerSlab>;
+    };
+
+    template <typename U, std::size_t M>
+    friend class pool_allocator;
+
+private:
+    typename node_pool<NodesPerSlab>::fixed_pool& fixed_for_t() {
+        if (fixed == nullptr) {
+            fixed = pools->pool_for(sizeof(T), alignof(T));
+        }
+        return *fixed;
+    }
+
+    node_pool<NodesPerSlab>* pools;
+    typename node_pool<NodesPerSlab>::fixed_pool* fixed;
+};
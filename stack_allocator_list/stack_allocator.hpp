@@ -1,32 +1,209 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
 #include <memory>
+#include <memory_resource>
+#include <new>
 
 template <std::size_t N>
 class stack_storage {
 public:
-    stack_storage() : buff(), curr(buff) {}
-    
+    // Once buff is used up, storage continues in geometrically growing blocks
+    // taken from upstream; they are all returned when the storage dies.
+    explicit stack_storage(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : buff(), curr(buff), end(buff + N), free_lists()
+        , upstream(upstream), overflow(nullptr), next_block_size(N) {}
+
     stack_storage(const stack_storage&) = delete;
 
+    stack_storage& operator=(const stack_storage&) = delete;
+
+    ~stack_storage() {
+        while (overflow != nullptr) {
+            overflow_block* prev = overflow->prev;
+            upstream->deallocate(overflow, overflow->size, alignof(std::max_align_t));
+            overflow = prev;
+        }
+    }
+
     template <typename T, size_t M>
     friend class stack_allocator;
 
+    template <std::size_t M>
+    friend class stack_resource;
+
 private:
-    char* reserve(std::size_t amount) {
-        if ((curr - buff) + amount >= N) {
+    // A freed chunk holds the link to the next free chunk of its class.
+    struct free_chunk {
+        free_chunk* next;
+    };
+
+    // Header of an upstream block; the chain is walked only on destruction.
+    struct overflow_block {
+        overflow_block* prev;
+        std::size_t size;
+    };
+
+    // Every chunk is a multiple of granule bytes and starts granule-aligned,
+    // so any chunk of a class fits any later request of that class. Chunks
+    // aligned above granule, up to a cache line, are kept on separate lists
+    // per power of two, so an over-aligned request only gets chunks aligned
+    // for it; anything aligned further is never pooled.
+    static constexpr std::size_t granule = alignof(free_chunk);
+    static constexpr std::size_t max_class_size = 256;
+    static constexpr std::size_t class_count = max_class_size / granule;
+    static constexpr std::size_t max_pooled_alignment = 64;
+    static constexpr std::size_t alignment_count = std::countr_zero(max_pooled_alignment / granule) + 1;
+
+#if defined(STACK_ALLOCATOR_STATS)
+public:
+    // Counters kept only when built with STACK_ALLOCATOR_STATS; without it
+    // the hooks below are empty and stack_storage carries no extra state.
+    struct stats_type {
+        std::size_t bytes_reserved = 0;
+        std::size_t bytes_in_use = 0;
+        std::size_t peak_in_use = 0;
+        std::size_t padding_bytes = 0;
+        std::size_t allocations = 0;
+        // One bucket per size class; the last counts requests too big to pool.
+        std::size_t allocations_by_size[class_count + 1] = {};
+        std::size_t exhaustions = 0;
+    };
+
+    const stats_type& stats() const {
+        return counters;
+    }
+
+private:
+#endif
+
+    static std::size_t round_up(std::size_t amount) {
+        return (amount + granule - 1) / granule * granule;
+    }
+
+    static std::size_t size_class(std::size_t amount) {
+        return (amount - 1) / granule;
+    }
+
+    static std::size_t alignment_class(std::size_t alignment) {
+        return alignment <= granule ? 0 : std::countr_zero(alignment / granule);
+    }
+
+    static bool is_pooled(std::size_t amount) {
+        return amount != 0 && amount <= max_class_size;
+    }
+
+    static bool is_pooled(std::size_t amount, std::size_t alignment) {
+        return is_pooled(amount) && alignment <= max_pooled_alignment;
+    }
+
+    // Aligns within the current block; a fresh block gets enough slack to
+    // align the chunk there, so padding never exceeds the alignment.
+    char* reserve(std::size_t amount, std::size_t alignment) {
+        count_allocation(amount);
+        count_padding(round_up(amount) - amount);
+        amount = round_up(amount);
+        std::size_t space = end - curr;
+        void* ptr = curr;
+        if (std::align(alignment, amount, ptr, space) == nullptr) {
+            grow(amount + alignment);
+            space = end - curr;
+            ptr = curr;
+            std::align(alignment, amount, ptr, space);
+        }
+        count_padding(static_cast<char*>(ptr) - curr);
+        count_reserved(static_cast<char*>(ptr) - curr + amount);
+        curr = static_cast<char*>(ptr) + amount;
+        return curr - amount;
+    }
+
+    // Throws std::bad_alloc (from upstream) instead of handing out nullptr.
+    void grow(std::size_t amount) {
+        count_exhaustion();
+        std::size_t header = round_up(sizeof(overflow_block));
+        while (next_block_size < header + amount) {
+            next_block_size *= 2;
+        }
+        std::size_t size = round_up(next_block_size);
+        void* block = upstream->allocate(size, alignof(std::max_align_t));
+        overflow = new (block) overflow_block{overflow, size};
+        curr = static_cast<char*>(block) + header;
+        end = static_cast<char*>(block) + size;
+        next_block_size *= 2;
+    }
+
+    char* reuse(std::size_t amount, std::size_t alignment) {
+        if (!is_pooled(amount, alignment)) {
+            return nullptr;
+        }
+        free_chunk*& list = free_lists[alignment_class(alignment)][size_class(amount)];
+        if (list == nullptr) {
             return nullptr;
         }
-        cur += amount;
-        return cur - amount;
+        free_chunk* chunk = list;
+        list = chunk->next;
+        count_allocation(amount);
+        return reinterpret_cast<char*>(chunk);
+    }
+
+    // Must be given the alignment the chunk was requested with, so it lands on
+    // the list that requests of that alignment read.
+    void release(char* ptr, std::size_t amount, std::size_t alignment) {
+        count_deallocation(amount);
+        if (is_pooled(amount, alignment)) {
+            free_chunk*& list = free_lists[alignment_class(alignment)][size_class(amount)];
+            list = new (ptr) free_chunk{list};
+        }
+    }
+
+#if defined(STACK_ALLOCATOR_STATS)
+    void count_allocation(std::size_t amount) {
+        ++counters.allocations;
+        ++counters.allocations_by_size[is_pooled(amount) ? size_class(amount) : class_count];
+        counters.bytes_in_use += amount;
+        if (counters.bytes_in_use > counters.peak_in_use) {
+            counters.peak_in_use = counters.bytes_in_use;
+        }
+    }
+
+    void count_deallocation(std::size_t amount) {
+        counters.bytes_in_use -= amount;
     }
 
-    void allign(std::size_t aligment) {
-        std::size_t space = N - (curr - buff);
-        curr = std::align(aligment, aligment
-                        , static_cast<void*>(curr), space);
+    void count_padding(std::size_t amount) {
+        counters.padding_bytes += amount;
     }
 
+    void count_reserved(std::size_t amount) {
+        counters.bytes_reserved += amount;
+    }
+
+    void count_exhaustion() {
+        ++counters.exhaustions;
+    }
+#else
+    void count_allocation(std::size_t) {}
+
+    void count_deallocation(std::size_t) {}
+
+    void count_padding(std::size_t) {}
+
+    void count_reserved(std::size_t) {}
+
+    void count_exhaustion() {}
+#endif
+
     char buff[N];
     char* curr;
+    char* end;
+    free_chunk* free_lists[alignment_count][class_count];
+    std::pmr::memory_resource* upstream;
+    overflow_block* overflow;
+    std::size_t next_block_size;
+#if defined(STACK_ALLOCATOR_STATS)
+    stats_type counters;
+#endif
 };
 
 template <typename T, std::size_t N>
@@ -40,31 +217,106 @@ public:
     using size_type = std::size_t;
     using difference_type = std::ptrdiff_t;
 
-    explicit stack_allocator() : buff(&stack_storage<N>()) {}
-
     explicit stack_allocator(stack_storage<N>& st) : buff(&st) {}
-    
+
     template <typename U>
     explicit stack_allocator(const stack_allocator<U, N>& other)
         : buff(const_cast<stack_storage<N>*>(other.buff)) {}
 
     template <typename U>
-    stack_allocator<T>& operator=(const stack_allocator<U, N>& other) {
+    stack_allocator& operator=(const stack_allocator<U, N>& other) {
         buff = other.buff;
         return *this;
     }
 
+#if defined(__cpp_lib_allocate_at_least)
+    using allocation_result = std::allocation_result<T*, std::size_t>;
+#else
+    struct allocation_result {
+        T* ptr;
+        std::size_t count;
+    };
+#endif
+
+    // Freed chunks of the same size are reused before bumping further.
     T* allocate(std::size_t count) {
-        buff->allign(alignof(T));
-        return reinterpret_cast<T*>(buff->reserve(count));
+        if (char* chunk = buff->reuse(count * sizeof(T), alignof(T))) {
+            return reinterpret_cast<T*>(chunk);
+        }
+        return reinterpret_cast<T*>(buff->reserve(count * sizeof(T), alignof(T)));
+    }
+
+    // Chunks are whole granules: hand the rounding slack to the caller.
+    allocation_result allocate_at_least(std::size_t count) {
+        std::size_t usable = stack_storage<N>::round_up(count * sizeof(T)) / sizeof(T);
+        return {allocate(usable), usable};
     }
 
-    void deallocate(T* ptr, std::size_t count) {}
+    void deallocate(T* ptr, std::size_t count) {
+        buff->release(reinterpret_cast<char*>(ptr), count * sizeof(T), alignof(T));
+    }
+
+    template <typename U>
+    bool operator==(const stack_allocator<U, N>& other) const {
+        return buff == other.buff;
+    }
+
+    template <typename U>
+    bool operator!=(const stack_allocator<U, N>& other) const {
+        return buff != other.buff;
+    }
 
     template <typename U>
     struct rebind {
         using other = stack_allocator<U, N>;
     };
+
+#if defined(STACK_ALLOCATOR_STATS)
+    const typename stack_storage<N>::stats_type& stats() const {
+        return buff->stats();
+    }
+
+#endif
+    template <typename U, std::size_t M>
+    friend class stack_allocator;
+
 private:
     stack_storage<N>* buff;
-};
\ No newline at end of file
+};
+
+// Type-erased view of a stack_storage for std::pmr containers: the capacity
+// is no longer part of the container type.
+template <std::size_t N>
+class stack_resource : public std::pmr::memory_resource {
+public:
+    explicit stack_resource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : storage(upstream) {}
+
+    stack_resource(const stack_resource&) = delete;
+
+    stack_resource& operator=(const stack_resource&) = delete;
+
+#if defined(STACK_ALLOCATOR_STATS)
+    const typename stack_storage<N>::stats_type& stats() const {
+        return storage.stats();
+    }
+
+#endif
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (char* chunk = storage.reuse(bytes, alignment)) {
+            return chunk;
+        }
+        return storage.reserve(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+        storage.release(static_cast<char*>(ptr), bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    stack_storage<N> storage;
+};
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "concurrent_stack_resource.hpp"
+
+namespace {
+const int kThreads = 4;
+
+// Thread-safe upstream that counts what it hands out.
+class counting_resource : public std::pmr::memory_resource {
+public:
+    std::atomic<std::size_t> allocations{0};
+    std::atomic<std::size_t> live_bytes{0};
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        allocations.fetch_add(1);
+        live_bytes.fetch_add(bytes);
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+        live_bytes.fetch_sub(bytes);
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+bool aligned(const void* ptr, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+}
+
+TEST(atomic_stack_resource, concurrent_chunks_are_disjoint_and_aligned) {
+    counting_resource upstream;
+    {
+        atomic_stack_resource<16 * 1024> resource(&upstream);
+        std::vector<std::vector<char*>> chunks(kThreads);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < 1000; ++i) {
+                    std::size_t alignment = std::size_t{1} << (i % 7);
+                    char* chunk = static_cast<char*>(resource.allocate(24, alignment));
+                    EXPECT_TRUE(aligned(chunk, alignment));
+                    std::fill(chunk, chunk + 24, static_cast<char>(t));
+                    chunks[t].push_back(chunk);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        std::set<char*> starts;
+        for (int t = 0; t < kThreads; ++t) {
+            for (char* chunk : chunks[t]) {
+                EXPECT_TRUE(std::all_of(chunk, chunk + 24, [t](char c) { return c == t; }));
+                starts.insert(chunk);
+            }
+        }
+        EXPECT_EQ(starts.size(), kThreads * 1000u);
+        EXPECT_GT(upstream.allocations.load(), 0u);
+    }
+    EXPECT_EQ(upstream.live_bytes.load(), 0u);
+}
+
+TEST(thread_stack_resource, freed_chunk_is_reused_locally) {
+    thread_stack_resource<> resource;
+    void* first = resource.allocate(40);
+    resource.deallocate(first, 40);
+    EXPECT_EQ(resource.allocate(40), first);
+}
+
+TEST(thread_stack_resource, cross_thread_frees_reach_the_owner) {
+    thread_stack_resource<> resource;
+    std::vector<void*> chunks;
+    for (int i = 0; i < 100; ++i) {
+        chunks.push_back(resource.allocate(32));
+    }
+    std::thread([&] {
+        for (void* chunk : chunks) {
+            resource.deallocate(chunk, 32);
+        }
+    }).join();
+    std::set<void*> reused;
+    for (int i = 0; i < 100; ++i) {
+        reused.insert(resource.allocate(32));
+    }
+    EXPECT_EQ(reused, std::set<void*>(chunks.begin(), chunks.end()));
+}
+
+TEST(thread_stack_resource, exited_thread_heap_is_adopted) {
+    counting_resource upstream;
+    {
+        thread_stack_resource<> resource(&upstream);
+        for (int generation = 0; generation < 50; ++generation) {
+            std::thread([&] {
+                std::vector<void*> chunks;
+                for (int i = 0; i < 100; ++i) {
+                    chunks.push_back(resource.allocate(64));
+                }
+                for (void* chunk : chunks) {
+                    resource.deallocate(chunk, 64);
+                }
+            }).join();
+        }
+        // The main thread's id never matched any of the workers'.
+        void* chunk = resource.allocate(64);
+        resource.deallocate(chunk, 64);
+        EXPECT_EQ(upstream.allocations.load(), 1u);
+    }
+    EXPECT_EQ(upstream.live_bytes.load(), 0u);
+}
+
+TEST(thread_stack_resource, adopter_drains_frees_queued_on_orphan) {
+    thread_stack_resource<> resource;
+    std::vector<void*> chunks;
+    std::thread([&] {
+        for (int i = 0; i < 100; ++i) {
+            chunks.push_back(resource.allocate(48));
+        }
+    }).join();
+    for (void* chunk : chunks) {
+        resource.deallocate(chunk, 48);
+    }
+    std::set<void*> reused;
+    for (int i = 0; i < 100; ++i) {
+        reused.insert(resource.allocate(48));
+    }
+    EXPECT_EQ(reused, std::set<void*>(chunks.begin(), chunks.end()));
+}
+
+TEST(thread_stack_resource, thread_outliving_resource_leaves_it_alone) {
+    std::atomic<bool> allocated{false};
+    std::atomic<bool> destroyed{false};
+    auto resource = std::make_unique<thread_stack_resource<>>();
+    std::thread worker([&] {
+        EXPECT_NE(resource->allocate(16), nullptr);
+        allocated = true;
+        while (!destroyed) {
+            std::this_thread::yield();
+        }
+    });
+    while (!allocated) {
+        std::this_thread::yield();
+    }
+    resource.reset();
+    destroyed = true;
+    worker.join();
+}
+
+TEST(thread_stack_resource, concurrent_producer_consumer_stress) {
+    thread_stack_resource<> resource;
+    const int kChunks = 20'000;
+    std::vector<std::atomic<void*>> slots(kChunks);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = t; i < kChunks; i += kThreads) {
+                std::size_t bytes = 8 + 8 * (i % 32);
+                auto* chunk = static_cast<int*>(resource.allocate(bytes));
+                *chunk = i;
+                slots[i].store(chunk, std::memory_order_release);
+            }
+            for (int i = (t + 1) % kThreads; i < kChunks; i += kThreads) {
+                void* chunk;
+                while ((chunk = slots[i].load(std::memory_order_acquire)) == nullptr) {
+                    std::this_thread::yield();
+                }
+                EXPECT_EQ(*static_cast<int*>(chunk), i);
+                resource.deallocate(chunk, 8 + 8 * (i % 32));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
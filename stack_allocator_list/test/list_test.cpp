@@ -0,0 +1,248 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <list>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "list.hpp"
+#include "stack_allocator.hpp"
+
+namespace {
+// Copying throws once the shared budget of copies runs out.
+struct Fragile {
+    static inline int copies_left = -1;
+
+    int value;
+
+    explicit Fragile(int value) : value(value) {}
+
+    Fragile(const Fragile& other) : value(other.value) {
+        if (copies_left == 0) {
+            throw std::runtime_error("copy");
+        }
+        if (copies_left > 0) {
+            --copies_left;
+        }
+    }
+
+    Fragile& operator=(const Fragile&) = default;
+
+    bool operator==(const Fragile&) const = default;
+};
+
+// Comparison that throws on its n-th call.
+struct ThrowingLess {
+    int* calls_left;
+
+    template <typename T>
+    bool operator()(const T& first, const T& second) const {
+        if ((*calls_left)-- == 0) {
+            throw std::runtime_error("compare");
+        }
+        return first < second;
+    }
+};
+
+template <typename List>
+std::vector<int> contents(const List& items) {
+    std::vector<int> result;
+    for (const auto& item : items) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(item)>, Fragile>) {
+            result.push_back(item.value);
+        } else {
+            result.push_back(item);
+        }
+    }
+    return result;
+}
+
+list<int> random_list(std::size_t size, unsigned seed) {
+    std::mt19937 rng(seed);
+    list<int> items;
+    for (std::size_t i = 0; i < size; ++i) {
+        items.push_back(static_cast<int>(rng() % 50));
+    }
+    return items;
+}
+}
+
+TEST(list_sort, matches_std_list_and_is_stable) {
+    std::mt19937 rng(1);
+    list<std::pair<int, int>> items;
+    std::list<std::pair<int, int>> expected;
+    for (int i = 0; i < 1000; ++i) {
+        std::pair<int, int> item(static_cast<int>(rng() % 20), i);
+        items.push_back(item);
+        expected.push_back(item);
+    }
+    auto by_key = [](const auto& first, const auto& second) { return first.first < second.first; };
+    items.sort(by_key);
+    expected.sort(by_key);
+    EXPECT_TRUE(std::equal(items.begin(), items.end(), expected.begin(), expected.end()));
+    EXPECT_EQ(items.size(), 1000u);
+}
+
+TEST(list_sort, relinks_without_allocating) {
+    stack_storage<64 * 1024> storage;
+    list<int, stack_allocator<int, 64 * 1024>> items{stack_allocator<int, 64 * 1024>(storage)};
+    for (int i = 0; i < 500; ++i) {
+        items.push_back((i * 37) % 500);
+    }
+    std::vector<const int*> addresses;
+    for (const int& item : items) {
+        addresses.push_back(&item);
+    }
+    std::size_t allocations = storage.stats().allocations;
+    items.sort();
+    EXPECT_EQ(storage.stats().allocations, allocations);
+    for (const int& item : items) {
+        EXPECT_EQ(addresses[(item * 473) % 500], &item);
+    }
+}
+
+TEST(list_sort, throwing_compare_keeps_original_order) {
+    list<int> items = random_list(300, 2);
+    std::vector<int> before = contents(items);
+    for (int fail_at : {0, 1, 7, 100, 1000, 2000}) {
+        int calls_left = fail_at;
+        EXPECT_THROW(items.sort(ThrowingLess{&calls_left}), std::runtime_error);
+        EXPECT_EQ(contents(items), before);
+        EXPECT_EQ(items.size(), before.size());
+        EXPECT_EQ(std::distance(items.rbegin(), items.rend()), 300);
+    }
+}
+
+TEST(list_merge, is_stable_and_empties_other) {
+    list<int> first;
+    list<int> second;
+    for (int i : {1, 3, 3, 5}) {
+        first.push_back(i);
+    }
+    for (int i : {0, 3, 4, 6}) {
+        second.push_back(i);
+    }
+    const int* first_three = &*std::next(first.begin());
+    first.merge(second);
+    EXPECT_EQ(contents(first), (std::vector<int>{0, 1, 3, 3, 3, 4, 5, 6}));
+    EXPECT_EQ(&*std::next(first.begin(), 2), first_three);
+    EXPECT_TRUE(second.empty());
+    EXPECT_EQ(first.size(), 8u);
+}
+
+TEST(list_merge, into_empty_list) {
+    list<int> first;
+    list<int> second = random_list(10, 3);
+    second.sort();
+    std::vector<int> expected = contents(second);
+    first.merge(second);
+    EXPECT_EQ(contents(first), expected);
+    EXPECT_TRUE(second.empty());
+}
+
+TEST(list_merge, throwing_compare_keeps_both_lists) {
+    list<int> first = random_list(50, 4);
+    list<int> second = random_list(50, 5);
+    first.sort();
+    second.sort();
+    std::vector<int> first_before = contents(first);
+    std::vector<int> second_before = contents(second);
+    for (int fail_at : {0, 1, 30, 90}) {
+        int calls_left = fail_at;
+        EXPECT_THROW(first.merge(second, ThrowingLess{&calls_left}), std::runtime_error);
+        EXPECT_EQ(contents(first), first_before);
+        EXPECT_EQ(contents(second), second_before);
+        EXPECT_EQ(std::distance(second.rbegin(), second.rend()), 50);
+    }
+}
+
+TEST(list_splice, moves_nodes_and_sizes) {
+    list<int> first = random_list(5, 6);
+    list<int> second = random_list(5, 7);
+    std::vector<int> expected = contents(second);
+    first.splice(first.begin(), second, std::next(second.begin()), std::prev(second.end()));
+    EXPECT_EQ(first.size(), 8u);
+    EXPECT_EQ(second.size(), 2u);
+    EXPECT_EQ(std::vector<int>(first.begin(), std::next(first.begin(), 3)),
+              std::vector<int>(expected.begin() + 1, expected.end() - 1));
+    first.splice(first.end(), second);
+    EXPECT_EQ(first.size(), 10u);
+    EXPECT_TRUE(second.empty());
+}
+
+TEST(list_unique, throwing_predicate_keeps_list) {
+    list<int> items;
+    for (int i : {1, 1, 2, 2, 2, 3, 1, 1}) {
+        items.push_back(i);
+    }
+    std::vector<int> before = contents(items);
+    int calls = 0;
+    EXPECT_THROW(items.unique([&](int first, int second) {
+        if (++calls == 5) {
+            throw std::runtime_error("predicate");
+        }
+        return first == second;
+    }), std::runtime_error);
+    EXPECT_EQ(contents(items), before);
+    EXPECT_EQ(items.unique(), 4u);
+    EXPECT_EQ(contents(items), (std::vector<int>{1, 2, 3, 1}));
+}
+
+TEST(list_remove_if, throwing_predicate_keeps_list) {
+    list<int> items = random_list(40, 8);
+    std::vector<int> before = contents(items);
+    int calls = 0;
+    EXPECT_THROW(items.remove_if([&](int item) {
+        if (++calls == 30) {
+            throw std::runtime_error("predicate");
+        }
+        return item % 2 == 0;
+    }), std::runtime_error);
+    EXPECT_EQ(contents(items), before);
+    EXPECT_EQ(items.size(), 40u);
+}
+
+TEST(list_insert, throwing_copy_in_range_keeps_list) {
+    list<Fragile> items;
+    for (int i = 0; i < 5; ++i) {
+        items.push_back(Fragile(i));
+    }
+    std::vector<int> before = contents(items);
+    std::vector<Fragile> source;
+    for (int i = 10; i < 20; ++i) {
+        source.emplace_back(i);
+    }
+    Fragile::copies_left = 4;
+    EXPECT_THROW(items.insert(std::next(items.begin(), 2), source.begin(), source.end()), std::runtime_error);
+    Fragile::copies_left = 2;
+    EXPECT_THROW(items.insert(items.end(), 5, Fragile(7)), std::runtime_error);
+    Fragile::copies_left = -1;
+    EXPECT_EQ(contents(items), before);
+    EXPECT_EQ(items.size(), 5u);
+}
+
+TEST(list_insert, throwing_copy_in_copy_and_assignment) {
+    list<Fragile> items;
+    for (int i = 0; i < 5; ++i) {
+        items.push_back(Fragile(i));
+    }
+    list<Fragile> target;
+    target.push_back(Fragile(42));
+    Fragile::copies_left = 3;
+    EXPECT_THROW(list<Fragile> copy(items), std::runtime_error);
+    Fragile::copies_left = 3;
+    EXPECT_THROW(target = items, std::runtime_error);
+    Fragile::copies_left = -1;
+    EXPECT_EQ(contents(target), std::vector<int>{42});
+}
+
+TEST(list_erase, range) {
+    list<int> items = random_list(10, 9);
+    std::vector<int> expected = contents(items);
+    auto next = items.erase(std::next(items.begin(), 2), std::next(items.begin(), 7));
+    expected.erase(expected.begin() + 2, expected.begin() + 7);
+    EXPECT_EQ(contents(items), expected);
+    EXPECT_EQ(*next, expected[2]);
+    EXPECT_EQ(items.size(), 5u);
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <set>
+#include <type_traits>
+#include <vector>
+
+#include "list.hpp"
+#include "pool_allocator.hpp"
+
+namespace {
+// Counts what reaches upstream, so slab traffic is visible.
+class counting_resource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+    std::size_t live_bytes = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        live_bytes += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+        live_bytes -= bytes;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+struct alignas(64) CacheLine {
+    int value;
+};
+
+struct alignas(256) Page {
+    int value;
+};
+
+bool aligned(const void* ptr, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+}
+
+static_assert(std::is_nothrow_constructible_v<pool_allocator<int>, node_pool<>&>);
+static_assert(std::is_nothrow_constructible_v<pool_allocator<double>, const pool_allocator<int>&>);
+static_assert(std::is_nothrow_copy_constructible_v<pool_allocator<int>>);
+
+TEST(pool_allocator, construction_and_rebinding_allocate_nothing) {
+    counting_resource upstream;
+    node_pool<> pool(false, &upstream);
+    pool_allocator<int> ints(pool);
+    pool_allocator<CacheLine> lines(ints);
+    pool_allocator<int> back(lines);
+    EXPECT_EQ(upstream.allocations, 0u);
+    EXPECT_TRUE(ints == lines);
+    EXPECT_TRUE(back == ints);
+}
+
+TEST(pool_allocator, rebound_copies_share_nodes) {
+    node_pool<> pool;
+    pool_allocator<int> ints(pool);
+    int* first = ints.allocate(1);
+    pool_allocator<char> chars(ints);
+    pool_allocator<int> again(chars);
+    again.deallocate(first, 1);
+    EXPECT_EQ(ints.allocate(1), first);
+}
+
+TEST(pool_allocator, serves_node_containers) {
+    node_pool<> pool;
+    std::map<int, int, std::less<>, pool_allocator<std::pair<const int, int>>> table{
+        pool_allocator<std::pair<const int, int>>(pool)};
+    list<int, pool_allocator<int>> items{pool_allocator<int>(pool)};
+    for (int i = 0; i < 1000; ++i) {
+        table[i] = i;
+        items.push_back(i);
+    }
+    list<int, pool_allocator<int>> copy(items);
+    EXPECT_EQ(copy.size(), 1000u);
+    EXPECT_EQ(table.size(), 1000u);
+}
+
+TEST(pool_allocator, arrays_go_upstream) {
+    counting_resource upstream;
+    node_pool<> pool(false, &upstream);
+    std::vector<int, pool_allocator<int>> numbers{pool_allocator<int>(pool)};
+    numbers.resize(1000);
+    EXPECT_GE(upstream.live_bytes, 1000 * sizeof(int));
+    numbers = std::vector<int, pool_allocator<int>>(pool_allocator<int>(pool));
+    numbers.shrink_to_fit();
+    EXPECT_EQ(upstream.live_bytes, 0u);
+}
+
+TEST(pool_allocator, empty_slabs_are_kept_by_default) {
+    counting_resource upstream;
+    node_pool<16> pool(false, &upstream);
+    pool_allocator<int, 16> alloc(pool);
+    std::vector<int*> nodes;
+    for (int i = 0; i < 160; ++i) {
+        nodes.push_back(alloc.allocate(1));
+    }
+    std::size_t peak = upstream.live_bytes;
+    for (int* node : nodes) {
+        alloc.deallocate(node, 1);
+    }
+    EXPECT_EQ(upstream.live_bytes, peak);
+}
+
+TEST(pool_allocator, empty_slabs_return_upstream) {
+    counting_resource upstream;
+    {
+        node_pool<16> pool(true, &upstream);
+        pool_allocator<int, 16> alloc(pool);
+        std::vector<int*> nodes;
+        for (int i = 0; i < 160; ++i) {
+            nodes.push_back(alloc.allocate(1));
+        }
+        std::size_t peak = upstream.live_bytes;
+        std::size_t slabs = upstream.allocations;
+        ASSERT_GE(slabs, 2u);
+        for (int* node : nodes) {
+            alloc.deallocate(node, 1);
+        }
+        EXPECT_EQ(upstream.live_bytes, peak / slabs);
+        // The slab kept back serves the next burst.
+        alloc.deallocate(alloc.allocate(1), 1);
+        EXPECT_EQ(upstream.allocations, slabs);
+    }
+    EXPECT_EQ(upstream.live_bytes, 0u);
+}
+
+TEST(pool_allocator, over_aligned_nodes) {
+    node_pool<> pool;
+    pool_allocator<CacheLine> lines(pool);
+    pool_allocator<Page> pages(lines);
+    std::set<void*> seen;
+    for (int i = 0; i < 200; ++i) {
+        CacheLine* line = lines.allocate(1);
+        Page* page = pages.allocate(1);
+        EXPECT_TRUE(aligned(line, alignof(CacheLine)));
+        EXPECT_TRUE(aligned(page, alignof(Page)));
+        EXPECT_TRUE(seen.insert(line).second);
+        EXPECT_TRUE(seen.insert(page).second);
+    }
+    Page* page = pages.allocate(1);
+    pages.deallocate(page, 1);
+    EXPECT_EQ(pages.allocate(1), page);
+}
+
+TEST(pool_allocator, types_of_one_stride_share_a_pool) {
+    counting_resource upstream;
+    node_pool<> pool(false, &upstream);
+    pool_allocator<std::int64_t> wide(pool);
+    pool_allocator<double> reals(wide);
+    std::int64_t* node = wide.allocate(1);
+    wide.deallocate(node, 1);
+    EXPECT_EQ(static_cast<void*>(reals.allocate(1)), static_cast<void*>(node));
+    EXPECT_EQ(upstream.allocations, 1u);
+}
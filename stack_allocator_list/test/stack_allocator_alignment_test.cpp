@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <list>
+#include <memory_resource>
+#include <vector>
+
+#include "stack_allocator.hpp"
+
+namespace {
+const std::size_t kBuffer = 64 * 1024;
+
+struct alignas(64) CacheLine {
+    int value;
+};
+
+bool aligned(const void* ptr, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+}
+
+TEST(stack_allocator_alignment, cache_line_nodes_churn_in_bounded_memory) {
+    stack_storage<kBuffer> storage(std::pmr::null_memory_resource());
+    std::list<CacheLine, stack_allocator<CacheLine, kBuffer>> items{stack_allocator<CacheLine, kBuffer>(storage)};
+    for (int i = 0; i < 100; ++i) {
+        items.push_back({i});
+    }
+    // The first push of the churn holds 101 nodes at once; after it, every
+    // push should take back the node the previous pop freed.
+    items.push_back({-1});
+    items.pop_front();
+    std::size_t reserved = storage.stats().bytes_reserved;
+    for (int round = 0; round < 10'000; ++round) {
+        items.push_back({round});
+        EXPECT_TRUE(aligned(&items.back(), alignof(CacheLine)));
+        items.pop_front();
+    }
+    EXPECT_EQ(storage.stats().bytes_reserved, reserved);
+    EXPECT_EQ(storage.stats().exhaustions, 0u);
+}
+
+TEST(stack_allocator_alignment, padding_never_exceeds_alignment) {
+    stack_storage<kBuffer> storage;
+    stack_allocator<char, kBuffer> bytes(storage);
+    stack_allocator<CacheLine, kBuffer> lines(storage);
+    for (int i = 0; i < 100; ++i) {
+        std::size_t padding = storage.stats().padding_bytes;
+        bytes.allocate(1 + i % 7);
+        CacheLine* line = lines.allocate(1);
+        EXPECT_TRUE(aligned(line, alignof(CacheLine)));
+        EXPECT_LT(storage.stats().padding_bytes - padding, 2 * alignof(CacheLine));
+    }
+}
+
+TEST(stack_allocator_alignment, allocate_at_least_reports_usable_size) {
+    stack_storage<kBuffer> storage;
+    stack_allocator<char, kBuffer> alloc(storage);
+    auto result = alloc.allocate_at_least(3);
+    EXPECT_GE(result.count, 3u);
+    EXPECT_EQ(result.count % alignof(void*), 0u);
+    char* next = alloc.allocate(1);
+    EXPECT_GE(next, result.ptr + result.count);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include "stack_allocator.hpp"
+
+namespace {
+const std::size_t kBuffer = 4096;
+
+struct alignas(32) Wide {
+    char bytes[32];
+};
+
+bool aligned(const void* ptr, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+}
+
+TEST(stack_allocator, freed_chunk_is_reused) {
+    stack_storage<kBuffer> storage;
+    stack_allocator<int, kBuffer> alloc(storage);
+    int* first = alloc.allocate(4);
+    alloc.deallocate(first, 4);
+    int* second = alloc.allocate(4);
+    EXPECT_EQ(first, second);
+    alloc.deallocate(second, 4);
+}
+
+TEST(stack_allocator, reuse_is_per_size_class) {
+    stack_storage<kBuffer> storage;
+    stack_allocator<int, kBuffer> alloc(storage);
+    int* small = alloc.allocate(2);
+    alloc.deallocate(small, 2);
+    int* large = alloc.allocate(16);
+    EXPECT_NE(small, large);
+    alloc.deallocate(large, 16);
+}
+
+TEST(stack_allocator, over_aligned_chunk_is_reused) {
+    stack_storage<kBuffer> storage;
+    stack_allocator<Wide, kBuffer> alloc(storage);
+    Wide* first = alloc.allocate(1);
+    alloc.deallocate(first, 1);
+    Wide* second = alloc.allocate(1);
+    EXPECT_EQ(first, second);
+    EXPECT_TRUE(aligned(second, alignof(Wide)));
+    alloc.deallocate(second, 1);
+}
+
+TEST(stack_allocator, plain_chunk_never_serves_over_aligned_request) {
+    stack_storage<kBuffer> storage;
+    stack_allocator<char, kBuffer> bytes(storage);
+    stack_allocator<Wide, kBuffer> wide(storage);
+    std::vector<char*> freed;
+    for (int i = 0; i < 8; ++i) {
+        freed.push_back(bytes.allocate(sizeof(Wide)));
+    }
+    for (char* chunk : freed) {
+        bytes.deallocate(chunk, sizeof(Wide));
+    }
+    for (int i = 0; i < 8; ++i) {
+        Wide* chunk = wide.allocate(1);
+        EXPECT_TRUE(aligned(chunk, alignof(Wide)));
+        wide.deallocate(chunk, 1);
+    }
+}
+
+TEST(stack_allocator, list_churn_stays_inside_the_buffer) {
+    stack_storage<kBuffer> storage(std::pmr::null_memory_resource());
+    std::list<int, stack_allocator<int, kBuffer>> items{stack_allocator<int, kBuffer>(storage)};
+    for (int round = 0; round < 1000; ++round) {
+        for (int i = 0; i < 50; ++i) {
+            items.push_back(i);
+        }
+        for (int i = 0; i < 50; ++i) {
+            items.pop_front();
+        }
+    }
+    EXPECT_EQ(storage.stats().exhaustions, 0u);
+    EXPECT_LE(storage.stats().bytes_reserved, kBuffer);
+    EXPECT_EQ(storage.stats().bytes_in_use, 0u);
+}
+
+TEST(stack_resource, over_aligned_chunk_is_reused) {
+    stack_resource<kBuffer> resource(std::pmr::null_memory_resource());
+    for (std::size_t alignment : {16u, 32u, 64u}) {
+        void* first = resource.allocate(64, alignment);
+        resource.deallocate(first, 64, alignment);
+        void* second = resource.allocate(64, alignment);
+        EXPECT_EQ(first, second);
+        EXPECT_TRUE(aligned(second, alignment));
+        resource.deallocate(second, 64, alignment);
+    }
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <list>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "stack_allocator.hpp"
+
+namespace {
+// Counts what reaches upstream, to tell buffer hits from overflow.
+class counting_resource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+    std::size_t live_bytes = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        live_bytes += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+        live_bytes -= bytes;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+}
+
+TEST(stack_resource, containers_of_different_capacities_share_a_type) {
+    stack_resource<1024> small(std::pmr::null_memory_resource());
+    stack_resource<64 * 1024> large(std::pmr::null_memory_resource());
+    std::pmr::vector<int> first(&small);
+    std::pmr::vector<int> second(&large);
+    first.assign({1, 2, 3});
+    second = first;
+    EXPECT_EQ(second.size(), 3u);
+    EXPECT_EQ(second.get_allocator().resource(), &large);
+}
+
+TEST(stack_resource, pmr_containers_stay_in_the_buffer) {
+    stack_resource<64 * 1024> resource(std::pmr::null_memory_resource());
+    std::pmr::list<int> items(&resource);
+    std::pmr::unordered_map<int, int> table(&resource);
+    for (int i = 0; i < 500; ++i) {
+        items.push_back(i);
+        table[i] = i;
+    }
+    EXPECT_EQ(table.size(), 500u);
+    EXPECT_EQ(resource.stats().exhaustions, 0u);
+}
+
+TEST(stack_resource, honours_requested_alignment) {
+    stack_resource<4096> resource;
+    for (std::size_t alignment = 1; alignment <= 256; alignment *= 2) {
+        void* ptr = resource.allocate(3, alignment);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % alignment, 0u);
+    }
+}
+
+TEST(stack_resource, overflows_to_upstream_and_returns_it) {
+    counting_resource upstream;
+    {
+        stack_resource<256> resource(&upstream);
+        std::pmr::vector<std::pmr::string> words(&resource);
+        for (int i = 0; i < 100; ++i) {
+            words.emplace_back("a string long enough to leave the small buffer");
+        }
+        EXPECT_GT(upstream.allocations, 0u);
+        EXPECT_GT(resource.stats().exhaustions, 0u);
+    }
+    EXPECT_EQ(upstream.live_bytes, 0u);
+}
+
+TEST(stack_resource, compares_equal_only_to_itself) {
+    stack_resource<256> first;
+    stack_resource<256> second;
+    EXPECT_TRUE(first.is_equal(first));
+    EXPECT_FALSE(first.is_equal(second));
+}
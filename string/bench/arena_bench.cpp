@@ -0,0 +1,50 @@
+#include <chrono>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+
+#include "string.hpp"
+
+// Simulates request handling: each request builds a few dozen short-lived
+// strings and drops them together. The arena variant releases a request's
+// memory with one reset instead of one free per buffer.
+namespace {
+template <typename Str, typename MakeAlloc>
+double run(size_t requests, MakeAlloc make_alloc, std::pmr::monotonic_buffer_resource* arena) {
+  auto start = std::chrono::steady_clock::now();
+  size_t total = 0;
+  for (size_t request = 0; request < requests; ++request) {
+    {
+      Str path("/api/v1/items/", make_alloc());
+      for (int i = 0; i < 32; ++i) {
+        Str header("x-request-header-", make_alloc());
+        header.push_back(static_cast<char>('a' + i % 26));
+        header.push_back(':');
+        header.push_back(' ');
+        header.replace_all("-", "_");
+        path.push_back(static_cast<char>('0' + i % 10));
+        total += header.length();
+      }
+      total += path.length();
+    }
+    if (arena != nullptr) {
+      arena->release();
+    }
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  if (total == 0) {
+    std::cout << "";
+  }
+  return elapsed.count();
+}
+}
+
+int main() {
+  const size_t requests = 200'000;
+  char buffer[64 * 1024];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+  using PmrString = my::BasicString<std::pmr::polymorphic_allocator<char>>;
+  std::cout << "request-scoped strings, " << requests << " requests x 32 strings\n";
+  std::cout << "  arena: " << run<PmrString>(requests, [&] { return std::pmr::polymorphic_allocator<char>(&arena); }, &arena) << " ms\n";
+  std::cout << "  heap:  " << run<my::String>(requests, [] { return std::allocator<char>(); }, nullptr) << " ms\n";
+}
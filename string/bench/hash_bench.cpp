@@ -0,0 +1,46 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "string.hpp"
+
+// Looks up every key of a cache-resident 20k-entry unordered_map 100 times,
+// keyed by my::String and by std::string with the same contents, so the
+// time goes into hashing and comparing rather than cache misses.
+namespace {
+template <typename Key>
+double run(const std::vector<Key>& keys) {
+  std::unordered_map<Key, size_t> map;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    map.emplace(keys[i], i);
+  }
+  auto start = std::chrono::steady_clock::now();
+  size_t found = 0;
+  for (int round = 0; round < 100; ++round) {
+    for (const Key& key : keys) {
+      found += map.find(key)->second;
+    }
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  if (found == 0) {
+    std::cout << "";
+  }
+  return elapsed.count();
+}
+}
+
+int main() {
+  const size_t count = 20'000;
+  std::vector<std::string> std_keys;
+  std::vector<my::String> my_keys;
+  for (size_t i = 0; i < count; ++i) {
+    std::string key = "/api/v1/users/" + std::to_string(i * 7919) + "/profile/settings/notifications/email/weekly-digest/preferences?format=json&locale=en-US";
+    std_keys.push_back(key);
+    my_keys.emplace_back(my::StringView(key.data(), key.size()));
+  }
+  std::cout << "unordered_map lookups, " << count << " keys x 100\n";
+  std::cout << "  my::String:  " << run(my_keys) << " ms\n";
+  std::cout << "  std::string: " << run(std_keys) << " ms\n";
+}
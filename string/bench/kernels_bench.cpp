@@ -0,0 +1,119 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "string_kernels.hpp"
+
+// Bandwidth of each kernel over a 64 MiB buffer against a plain byte loop,
+// in GB/s (best of five passes).
+namespace {
+const size_t kSize = 64 << 20;
+
+volatile size_t sink;
+
+template <typename F>
+double gigabytes_per_second(F f) {
+  double best = 0;
+  for (int pass = 0; pass < 5; ++pass) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double rate = kSize / elapsed.count() / 1e9;
+    best = rate > best ? rate : best;
+  }
+  return best;
+}
+
+// Table-free byte-at-a-time validator, the baseline for is_valid_utf8.
+bool validate_bytewise(const std::string& str) {
+  size_t pos = 0;
+  while (pos < str.size()) {
+    uint8_t lead = static_cast<uint8_t>(str[pos]);
+    size_t length = lead < 0x80 ? 1 : lead >> 5 == 0x6 ? 2 : lead >> 4 == 0xE ? 3 : lead >> 3 == 0x1E ? 4 : 0;
+    if (length == 0 || pos + length > str.size()) {
+      return false;
+    }
+    uint32_t code = length == 1 ? lead : lead & (0x7F >> length);
+    for (size_t i = 1; i < length; ++i) {
+      uint8_t next = static_cast<uint8_t>(str[pos + i]);
+      if ((next & 0xC0) != 0x80) {
+        return false;
+      }
+      code = code << 6 | (next & 0x3F);
+    }
+    const uint32_t kMinimum[] = {0, 0, 0x80, 0x800, 0x10000};
+    if (code < kMinimum[length] || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) {
+      return false;
+    }
+    pos += length;
+  }
+  return true;
+}
+
+void report(const char* name, double kernel, double scalar) {
+  std::cout << "  " << name << ": kernel " << kernel << " GB/s, byte loop " << scalar << " GB/s\n";
+}
+}
+
+int main() {
+  std::mt19937 rng(1);
+  std::string text(kSize, ' ');
+  for (char& chr : text) {
+    chr = static_cast<char>('A' + rng() % 58);
+  }
+  std::string utf8;
+  const char* pieces[] = {"plain ascii text ", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80"};
+  while (utf8.size() < kSize) {
+    utf8 += pieces[rng() % 4];
+  }
+  utf8.resize(kSize - 8);
+  utf8 += "        ";
+
+  std::cout << (kSize >> 20) << " MiB buffers\n";
+  report("ascii_to_lower   ", gigabytes_per_second([&] { my::ascii_to_lower(text.data(), text.size()); }),
+         gigabytes_per_second([&] {
+           for (char& chr : text) {
+             chr = chr >= 'A' && chr <= 'Z' ? static_cast<char>(chr + 32) : chr;
+           }
+         }));
+  report("ascii_to_upper   ", gigabytes_per_second([&] { my::ascii_to_upper(text.data(), text.size()); }),
+         gigabytes_per_second([&] {
+           for (char& chr : text) {
+             chr = chr >= 'a' && chr <= 'z' ? static_cast<char>(chr - 32) : chr;
+           }
+         }));
+
+  std::string padded(kSize, ' ');
+  padded[kSize / 2] = 'x';
+  report("trim (32 MiB runs)", gigabytes_per_second([&] { sink = my::trim(my::StringView(padded.data(), kSize)).length(); }),
+         gigabytes_per_second([&] {
+           size_t begin = 0;
+           size_t end = padded.size();
+           while (begin < end && padded[begin] == ' ') {
+             ++begin;
+           }
+           while (end > begin && padded[end - 1] == ' ') {
+             --end;
+           }
+           sink = end - begin;
+         }));
+
+  std::string ascii(kSize, 'a');
+  report("is_valid_utf8 (ascii)",
+         gigabytes_per_second([&] { sink = my::is_valid_utf8(my::StringView(ascii.data(), kSize)); }),
+         gigabytes_per_second([&] { sink = validate_bytewise(ascii); }));
+  report("is_valid_utf8 (mixed)",
+         gigabytes_per_second([&] { sink = my::is_valid_utf8(my::StringView(utf8.data(), utf8.size())); }),
+         gigabytes_per_second([&] { sink = validate_bytewise(utf8); }));
+  report("count_code_points",
+         gigabytes_per_second([&] { sink = my::count_code_points(my::StringView(utf8.data(), utf8.size())); }),
+         gigabytes_per_second([&] {
+           size_t count = 0;
+           for (char chr : utf8) {
+             count += (static_cast<uint8_t>(chr) & 0xC0) != 0x80;
+           }
+           sink = count;
+         }));
+}
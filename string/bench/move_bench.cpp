@@ -0,0 +1,35 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "string.hpp"
+
+// Grows a vector of strings one push at a time. With noexcept moves every
+// reallocation relocates buffers; copy_only forces the old deep copies.
+namespace {
+struct CopyOnly {
+  CopyOnly(const char* str) : str(str) {}
+  CopyOnly(const CopyOnly&) = default;
+  CopyOnly& operator=(const CopyOnly&) = default;
+
+  my::String str;
+};
+
+template <typename T>
+double run(size_t count) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<T> strings;
+  for (size_t i = 0; i < count; ++i) {
+    strings.emplace_back("a string long enough to need its own heap buffer");
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+}
+
+int main() {
+  const size_t count = 1'000'000;
+  std::cout << "vector<String> growth, " << count << " elements\n";
+  std::cout << "  move:      " << run<my::String>(count) << " ms\n";
+  std::cout << "  copy only: " << run<CopyOnly>(count) << " ms\n";
+}
@@ -0,0 +1,55 @@
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "string.hpp"
+
+// Reads a whitespace-separated text token by token and line by line into a
+// reused destination, with my::String and std::string. Short tokens show
+// the per-call overhead, long ones the chunked copying.
+namespace {
+volatile size_t sink;
+
+std::string make_text(size_t token_length, size_t total) {
+  std::string text;
+  while (text.size() < total) {
+    text.append(token_length, 'w');
+    text.push_back(text.size() % 7 == 0 ? '\n' : ' ');
+  }
+  return text;
+}
+
+template <typename Str, typename Read>
+double run(const std::string& text, Read read) {
+  std::istringstream in(text);
+  Str str;
+  size_t total = 0;
+  auto start = std::chrono::steady_clock::now();
+  while (read(in, str)) {
+    total += str.length();
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  sink = total;
+  return elapsed.count();
+}
+
+void compare(size_t token_length) {
+  std::string text = make_text(token_length, 64 << 20);
+  auto words = [](std::istream& in, auto& str) -> bool { return static_cast<bool>(in >> str); };
+  std::cout << "  " << token_length << "-byte tokens, >>: my::String "
+            << run<my::String>(text, words) << " ms, std::string " << run<std::string>(text, words) << " ms\n";
+  std::cout << "  " << token_length << "-byte tokens, getline: my::String "
+            << run<my::String>(text, [](std::istream& in, my::String& str) { return static_cast<bool>(my::getline(in, str)); })
+            << " ms, std::string "
+            << run<std::string>(text, [](std::istream& in, std::string& str) { return static_cast<bool>(std::getline(in, str)); })
+            << " ms\n";
+}
+}
+
+int main() {
+  std::cout << "64 MiB of text\n";
+  for (size_t token_length : {8u, 64u, 1000u}) {
+    compare(token_length);
+  }
+}
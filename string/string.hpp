@@ -1,38 +1,71 @@
 #pragma once
 
 #include <iostream>
+#include <cstdint>
 #include <cstring>
+#include <locale>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "string_kernels.hpp"
+#include "string_view.hpp"
 
 namespace my {
-class String {
+template <typename Allocator = std::allocator<char>>
+class BasicString {
+  using char_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<char>;
+  using alloc_traits = std::allocator_traits<char_allocator>;
+
  public:
-  String();
+  using allocator_type = Allocator;
+
+  BasicString() noexcept(noexcept(Allocator()));
+
+  explicit BasicString(const Allocator&) noexcept;
+
+  BasicString(const  char*, const Allocator& = Allocator());
+
+  BasicString(size_t , char, const Allocator& = Allocator());
+
+  BasicString(const BasicString&);
+
+  explicit BasicString(StringView, const Allocator& = Allocator());
+
+  BasicString(BasicString&&) noexcept;
+
+  BasicString& operator=(const BasicString&);
 
-  String(const  char*);
+  BasicString& operator=(BasicString&&) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value
+  );
 
-  String(size_t , char);
+  void swap(BasicString&) noexcept;
 
-  String(const String&);
+  friend void swap(BasicString& left, BasicString& right) noexcept { left.swap(right); }
+
+  Allocator get_allocator() const;
 
   char& operator[](size_t);
 
   const char& operator[](size_t) const;
 
-  friend bool operator==(const my::String& left, const my::String& right) {
-    if (left.size_ != right.size_) {
-      return false;
-    }
-    return !strcmp(left.buffer_, right.buffer_);
+  friend bool operator==(const BasicString& left, const BasicString& right) {
+    return StringView(left) == StringView(right);
+  }
+
+  friend std::strong_ordering operator<=>(const BasicString& left, const BasicString& right) {
+    return StringView(left) <=> StringView(right);
   }
 
   size_t length() const;
 
   void push_back(char);
-  
+
   void pop_back();
 
   const char& front() const;
-  
+
   char& front();
 
   const char& back() const;
@@ -41,39 +74,573 @@ class String {
 
   //String& operator+=(const String&);
 
-  size_t find(const String&) const;
-  
-  size_t rfind(const String&) const;
+  operator StringView() const { return StringView(buffer_, size_); }
+
+  StringView substr_view(size_t pos, size_t count = StringView::npos) const;
+
+  size_t find(StringView) const;
+
+  size_t rfind(StringView) const;
 
   bool empty() const;
 
   void clear();
 
-  friend std::ostream& operator<<(std::ostream& out, const String& str) {
+  BasicString& to_lower();
+
+  BasicString& to_upper();
+
+  BasicString& trim();
+
+  BasicString& replace_all(StringView from, StringView to);
+
+  // Takes ownership of a buffer of `capasity` bytes obtained from get_allocator(), holding `size` chars.
+  void adopt(char* buffer, size_t size, size_t capasity);
+
+  // Gives up the null-terminated buffer and its capasity; the caller frees it through get_allocator().
+  char* release(size_t& capasity);
+
+  friend std::ostream& operator<<(std::ostream& out, const BasicString& str) {
     out << str.buffer_;
     return out;
   }
 
-  friend std::istream& operator>>(std::istream& in, String& str) {
-    char buffer[100];
-    in >> buffer;
-    str.size_ = strlen(buffer);
-    str.capasity_ = str.size_;
-    str.buffer_ = new char[str.size_];
-    str.buffer_[str.size_] = '\0';
-    return in;
-  }
+  template <typename A>
+  friend std::istream& operator>>(std::istream&, BasicString<A>&);
 
-  
-  ~String();
+  template <typename A>
+  friend std::istream& getline(std::istream&, BasicString<A>&, char);
+
+  ~BasicString();
 
  private:
   void increase_buff();
 
   void decrease_buff();
 
+  bool owns_buff() const;
+
+  char* allocate_buff(size_t);
+
+  void free_buff();
+
+  void own_buff();
+
+  void assign(const char*, size_t);
+
+  void append(const char*, size_t);
+
+  static const size_t kReadChunk = 256;
+
+  // Shared by every empty string, so it is read-only: anything that may
+  // write through buffer_ must call own_buff() first.
+  inline static const char empty_buff_[1] = {'\0'};
+
+  static char* empty_buff() { return const_cast<char*>(empty_buff_); }
+
   size_t capasity_;
   size_t size_;
   char* buffer_;
+  [[no_unique_address]] char_allocator alloc_;
+};
+
+using String = BasicString<>;
+
+template <typename Allocator>
+std::istream& operator>>(std::istream&, BasicString<Allocator>&);
+
+template <typename Allocator>
+std::istream& getline(std::istream&, BasicString<Allocator>&, char = '\n');
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString() noexcept(noexcept(Allocator()))
+    : capasity_(0ULL), size_(0ULL), buffer_(empty_buff()), alloc_() {}
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString(const Allocator& alloc) noexcept
+    : capasity_(0ULL), size_(0ULL), buffer_(empty_buff()), alloc_(alloc) {}
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString(size_t size, char chr, const Allocator& alloc)
+    : capasity_(size + 1), size_(size), buffer_(nullptr), alloc_(alloc) {
+  buffer_ = allocate_buff(capasity_);
+  memset(buffer_, chr, size * sizeof(char));
+  buffer_[size_] = '\0';
+}
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString(const char str[], const Allocator& alloc)
+    : capasity_(strlen(str) + 1), size_(capasity_ - 1), buffer_(nullptr), alloc_(alloc) {
+  buffer_ = allocate_buff(capasity_);
+  memcpy(buffer_, str, capasity_);
+}
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString(const BasicString& str)
+    : BasicString(str.size_, '\0', Allocator(alloc_traits::select_on_container_copy_construction(str.alloc_))) {
+  memcpy(buffer_, str.buffer_, size_);
+}
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString(StringView view, const Allocator& alloc)
+    : BasicString(view.length(), '\0', alloc) {
+  memcpy(buffer_, view.data(), size_);
+}
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString(BasicString&& str) noexcept
+    : capasity_(str.capasity_), size_(str.size_), buffer_(str.buffer_), alloc_(std::move(str.alloc_)) {
+  str.capasity_ = 0;
+  str.size_ = 0;
+  str.buffer_ = empty_buff();
+}
+
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::operator=(const BasicString& str) {
+  if (this == &str) {
+    return *this;
+  }
+  if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+    if (alloc_ != str.alloc_) {
+      free_buff();
+    }
+    alloc_ = str.alloc_;
+  }
+  assign(str.buffer_, str.size_);
+  return *this;
+}
+
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::operator=(BasicString&& str) noexcept(
+    alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value
+) {
+  if (this == &str) {
+    return *this;
+  }
+  if constexpr (!alloc_traits::propagate_on_container_move_assignment::value) {
+    if (alloc_ != str.alloc_) {
+      assign(str.buffer_, str.size_);
+      return *this;
+    }
+  }
+  free_buff();
+  if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+    alloc_ = std::move(str.alloc_);
+  }
+  capasity_ = str.capasity_;
+  size_ = str.size_;
+  buffer_ = str.buffer_;
+  str.capasity_ = 0;
+  str.size_ = 0;
+  str.buffer_ = empty_buff();
+  return *this;
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::swap(BasicString& str) noexcept {
+  std::swap(capasity_, str.capasity_);
+  std::swap(size_, str.size_);
+  std::swap(buffer_, str.buffer_);
+  if constexpr (alloc_traits::propagate_on_container_swap::value) {
+    std::swap(alloc_, str.alloc_);
+  }
+}
+
+template <typename Allocator>
+Allocator BasicString<Allocator>::get_allocator() const {
+  return Allocator(alloc_);
+}
+
+template <typename Allocator>
+const char& BasicString<Allocator>::operator[](size_t index) const {
+  if (index >= size_) {
+    throw;
+  }
+
+  return buffer_[index];
+}
+
+template <typename Allocator>
+char& BasicString<Allocator>::operator[](size_t index) {
+  if (!owns_buff()) {
+    own_buff();
+  }
+  return this->buffer_[index];
+}
+
+template <typename Allocator>
+size_t BasicString<Allocator>::length() const { return this->size_; }
+
+template <typename Allocator>
+void BasicString<Allocator>::push_back(char chr) {
+  if (size_ + 1 >= capasity_) {
+    increase_buff();
+  }
+  buffer_[size_++] = chr;
+  buffer_[size_] = '\0';
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::pop_back() {
+  if (size_ == 0) {
+    throw;
+  }
+  --size_;
+  if (size_ * 4 == capasity_) {
+    decrease_buff();
+  }
+  buffer_[size_] = '\0';
+}
+
+template <typename Allocator>
+const char& BasicString<Allocator>::front() const {
+  if (size_ == 0) {
+    throw;
+  }
+  return this->buffer_[0];
+}
+
+template <typename Allocator>
+char& BasicString<Allocator>::front() {
+  return const_cast<char&>(static_cast<const BasicString&>(*this).front());
+}
+
+template <typename Allocator>
+const char& BasicString<Allocator>::back() const {
+  if (size_ == 0) {
+    throw;
+  }
+  return this->buffer_[size_ - 1];
+}
+
+template <typename Allocator>
+char& BasicString<Allocator>::back() {
+  return const_cast<char&>(static_cast<const BasicString&>(*this).back());
+}
+
+template <typename Allocator>
+StringView BasicString<Allocator>::substr_view(size_t pos, size_t count) const {
+  return StringView(*this).substr_view(pos, count);
+}
+
+template <typename Allocator>
+size_t BasicString<Allocator>::find(StringView substr) const { return StringView(*this).find(substr); }
+
+template <typename Allocator>
+size_t BasicString<Allocator>::rfind(StringView substr) const {
+  size_t it = this->find(substr);
+  if (it == this->size_) {
+    return it;
+  }
+  return it + substr.length() - 1;
+}
+
+template <typename Allocator>
+bool BasicString<Allocator>::empty() const { return size_ == 0; }
+
+template <typename Allocator>
+void BasicString<Allocator>::clear() {
+  free_buff();
+  buffer_ = empty_buff();
+  size_ = 0;
+  capasity_ = 0;
+}
+
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::to_lower() {
+  ascii_to_lower(buffer_, size_);
+  return *this;
+}
+
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::to_upper() {
+  ascii_to_upper(buffer_, size_);
+  return *this;
+}
+
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::trim() {
+  StringView trimmed = my::trim(*this);
+  if (trimmed.length() == size_) {
+    return *this;
+  }
+  memmove(buffer_, trimmed.data(), trimmed.length());
+  size_ = trimmed.length();
+  buffer_[size_] = '\0';
+  return *this;
+}
+
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::replace_all(StringView from, StringView to) {
+  size_t count = count_occurrences(*this, from);
+  if (count == 0) {
+    return *this;
+  }
+  size_t size = size_ - count * from.length() + count * to.length();
+  size_t capasity = size + 1;
+  char* tmp = allocate_buff(capasity);
+  StringView rest = *this;
+  char* out = tmp;
+  for (size_t i = 0; i < count; ++i) {
+    size_t pos = rest.find(from);
+    memcpy(out, rest.data(), pos);
+    out += pos;
+    if (!to.empty()) {
+      memcpy(out, to.data(), to.length());
+    }
+    out += to.length();
+    rest = rest.substr_view(pos + from.length());
+  }
+  if (!rest.empty()) {
+    memcpy(out, rest.data(), rest.length());
+  }
+  free_buff();
+  buffer_ = tmp;
+  capasity_ = capasity;
+  size_ = size;
+  buffer_[size_] = '\0';
+  return *this;
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::adopt(char* buffer, size_t size, size_t capasity) {
+  if (size >= capasity) {
+    throw std::length_error("String::adopt: no room for the terminator");
+  }
+  clear();
+  buffer_ = buffer;
+  size_ = size;
+  capasity_ = capasity;
+  buffer_[size_] = '\0';
+}
+
+template <typename Allocator>
+char* BasicString<Allocator>::release(size_t& capasity) {
+  if (!owns_buff()) {
+    capasity = 1;
+    char* buffer = allocate_buff(capasity);
+    buffer[0] = '\0';
+    return buffer;
+  }
+  char* buffer = buffer_;
+  capasity = capasity_;
+  buffer_ = empty_buff();
+  size_ = 0;
+  capasity_ = 0;
+  return buffer;
+}
+
+template <typename Allocator>
+BasicString<Allocator>::~BasicString() { free_buff(); }
+
+template <typename Allocator>
+std::istream& operator>>(std::istream& in, BasicString<Allocator>& str) {
+  std::istream::sentry sentry(in);
+  if (!sentry) {
+    return in;
+  }
+  str.size_ = 0;
+  if (str.owns_buff()) {
+    str.buffer_[0] = '\0';
+  }
+
+  using traits = std::istream::traits_type;
+  const std::ctype<char>& ctype = std::use_facet<std::ctype<char>>(in.getloc());
+  std::streambuf* source = in.rdbuf();
+  size_t limit = in.width() > 0 ? static_cast<size_t>(in.width()) : SIZE_MAX;
+  std::ios_base::iostate state = std::ios_base::goodbit;
+
+  char chunk[BasicString<Allocator>::kReadChunk];
+  size_t filled = 0;
+  size_t extracted = 0;
+  // A full width() stops before looking further, so it never sets eofbit.
+  for (traits::int_type ch = source->sgetc(); extracted < limit; ch = source->snextc()) {
+    if (traits::eq_int_type(ch, traits::eof())) {
+      state |= std::ios_base::eofbit;
+      break;
+    }
+    char chr = traits::to_char_type(ch);
+    if (ctype.is(std::ctype_base::space, chr)) {
+      break;
+    }
+    chunk[filled++] = chr;
+    ++extracted;
+    if (filled == BasicString<Allocator>::kReadChunk) {
+      str.append(chunk, filled);
+      filled = 0;
+    }
+  }
+  str.append(chunk, filled);
+
+  in.width(0);
+  if (extracted == 0) {
+    state |= std::ios_base::failbit;
+  }
+  in.setstate(state);
+  return in;
+}
+
+template <typename Allocator>
+std::istream& getline(std::istream& in, BasicString<Allocator>& str, char delim) {
+  std::istream::sentry sentry(in, true);
+  if (!sentry) {
+    return in;
+  }
+  str.size_ = 0;
+  if (str.owns_buff()) {
+    str.buffer_[0] = '\0';
+  }
+
+  // istream::getline scans the stream's buffer for delim in bulk; it only
+  // reports failbit when a chunk fills up before the line ends.
+  char chunk[BasicString<Allocator>::kReadChunk];
+  bool extracted = false;
+  while (true) {
+    in.getline(chunk, sizeof(chunk), delim);
+    size_t count = static_cast<size_t>(in.gcount());
+    if (in.eof()) {
+      str.append(chunk, count);
+      extracted = extracted || count > 0;
+      break;
+    }
+    if (!in.fail()) {
+      str.append(chunk, count - 1);
+      extracted = true;
+      break;
+    }
+    if (count + 1 != sizeof(chunk)) {
+      break;
+    }
+    str.append(chunk, count);
+    extracted = true;
+    in.clear(in.rdstate() & ~std::ios_base::failbit);
+  }
+
+  if (extracted) {
+    in.clear(in.rdstate() & ~std::ios_base::failbit);
+  } else {
+    in.setstate(std::ios_base::failbit);
+  }
+  return in;
+}
+
+template <typename Allocator>
+bool BasicString<Allocator>::owns_buff() const { return buffer_ != empty_buff_; }
+
+template <typename Allocator>
+char* BasicString<Allocator>::allocate_buff(size_t capasity) {
+  return alloc_traits::allocate(alloc_, capasity);
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::free_buff() {
+  if (owns_buff()) {
+    alloc_traits::deallocate(alloc_, buffer_, capasity_);
+    buffer_ = empty_buff();
+    capasity_ = 0;
+  }
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::own_buff() {
+  buffer_ = allocate_buff(1);
+  buffer_[0] = '\0';
+  capasity_ = 1;
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::assign(const char* str, size_t count) {
+  if (count >= capasity_) {
+    char* tmp = allocate_buff(count + 1);
+    free_buff();
+    buffer_ = tmp;
+    capasity_ = count + 1;
+  }
+  if (count != 0) {
+    memcpy(buffer_, str, count);
+  }
+  size_ = count;
+  if (owns_buff()) {
+    buffer_[size_] = '\0';
+  }
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::append(const char* chunk, size_t count) {
+  if (count == 0) {
+    return;
+  }
+  if (size_ + count >= capasity_) {
+    size_t capasity = capasity_ == 0 ? 2 : capasity_;
+    while (size_ + count >= capasity) {
+      capasity *= 2;
+    }
+    char* tmp = allocate_buff(capasity);
+    memcpy(tmp, buffer_, size_);
+    free_buff();
+    capasity_ = capasity;
+    buffer_ = tmp;
+  }
+  memcpy(buffer_ + size_, chunk, count);
+  size_ += count;
+  buffer_[size_] = '\0';
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::increase_buff() {
+  size_t capasity = capasity_ == 0 ? 2 : capasity_ * 2;
+  char* tmp = allocate_buff(capasity);
+  memcpy(tmp, buffer_, size_);
+  free_buff();
+  capasity_ = capasity;
+  buffer_ = tmp;
+  buffer_[size_] = '\0';
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::decrease_buff() {
+  size_t capasity = capasity_ / 2;
+  char* tmp = allocate_buff(capasity);
+  memcpy(tmp, buffer_, size_);
+  free_buff();
+  capasity_ = capasity;
+  buffer_ = tmp;
+  buffer_[size_] = '\0';
+}
+
+extern template class BasicString<std::allocator<char>>;
+
+extern template std::istream& operator>>(std::istream&, String&);
+
+extern template std::istream& getline(std::istream&, String&, char);
+
+// Immutable key that computes its hash once; compares hashes before bytes.
+class HashedString {
+ public:
+  HashedString(String str) : str_(std::move(str)), hash_(StringView(str_).hash()) {}
+
+  const String& str() const { return str_; }
+
+  size_t hash() const { return hash_; }
+
+  operator StringView() const { return str_; }
+
+  friend bool operator==(const HashedString& left, const HashedString& right) {
+    return left.hash_ == right.hash_ && left.str_ == right.str_;
+  }
+
+ private:
+  String str_;
+  size_t hash_;
+};
+}
+
+template <typename Allocator>
+struct std::hash<my::BasicString<Allocator>> {
+  size_t operator()(const my::BasicString<Allocator>& str) const noexcept { return my::StringView(str).hash(); }
+};
+
+template <>
+struct std::hash<my::HashedString> {
+  size_t operator()(const my::HashedString& str) const noexcept { return str.hash(); }
 };
-}
\ No newline at end of file
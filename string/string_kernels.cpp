@@ -0,0 +1,313 @@
+#include "string_kernels.hpp"
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define MY_STRING_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(MY_STRING_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define MY_STRING_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+using byte = unsigned char;
+
+int lowest_bit(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(mask);
+#else
+  int bit = 0;
+  while ((mask & 1) == 0) {
+    mask >>= 1;
+    ++bit;
+  }
+  return bit;
+#endif
+}
+
+int highest_bit(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 31 - __builtin_clz(mask);
+#else
+  int bit = 31;
+  while ((mask & 0x80000000U) == 0) {
+    mask <<= 1;
+    --bit;
+  }
+  return bit;
+#endif
+}
+
+bool use_avx2() {
+#if defined(MY_STRING_AVX2)
+  static const bool kHasAvx2 = __builtin_cpu_supports("avx2");
+  return kHasAvx2;
+#else
+  return false;
+#endif
+}
+
+bool is_space(byte chr) { return chr == ' ' || static_cast<byte>(chr - '\t') < 5; }
+
+// Flips bit 0x20 of every byte in [first, first + 26): the whole of case folding for ASCII letters.
+void flip_case_scalar(byte *data, size_t size, byte first) {
+  for (size_t i = 0; i < size; ++i) {
+    if (static_cast<byte>(data[i] - first) < 26) {
+      data[i] ^= 0x20;
+    }
+  }
+}
+
+size_t first_non_ascii_scalar(const byte *data, size_t pos, size_t size) {
+  while (pos < size && data[pos] < 0x80) {
+    ++pos;
+  }
+  return pos;
+}
+
+size_t count_continuations_scalar(const byte *data, size_t size) {
+  size_t count = 0;
+  for (size_t i = 0; i < size; ++i) {
+    count += (data[i] & 0xC0) == 0x80;
+  }
+  return count;
+}
+
+#if defined(MY_STRING_SSE2)
+// Signed compares only: bias the range start to -128 and test `< -128 + width`.
+__m128i in_range_sse2(__m128i chunk, byte first, byte width) {
+  __m128i biased = _mm_add_epi8(chunk, _mm_set1_epi8(static_cast<char>(0x80 - first)));
+  return _mm_cmplt_epi8(biased, _mm_set1_epi8(static_cast<char>(-128 + width)));
+}
+
+uint32_t space_mask_sse2(const byte *data) {
+  __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+  __m128i spaces = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), in_range_sse2(chunk, '\t', 5));
+  return static_cast<uint32_t>(_mm_movemask_epi8(spaces));
+}
+
+size_t flip_case_sse2(byte *data, size_t size, byte first) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    __m128i flip = _mm_and_si128(in_range_sse2(chunk, first, 26), _mm_set1_epi8(0x20));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), _mm_xor_si128(chunk, flip));
+  }
+  return i;
+}
+
+size_t first_non_ascii_sse2(const byte *data, size_t pos, size_t size) {
+  for (; pos + 16 <= size; pos += 16) {
+    uint32_t mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos)));
+    if (mask != 0) {
+      return pos + lowest_bit(mask);
+    }
+  }
+  return pos;
+}
+
+size_t count_continuations_sse2(const byte *data, size_t size, size_t &count) {
+  size_t i = 0;
+  while (i + 16 <= size) {
+    __m128i counters = _mm_setzero_si128();
+    for (int round = 0; round < 255 && i + 16 <= size; ++round, i += 16) {
+      __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+      counters = _mm_sub_epi8(counters, _mm_cmplt_epi8(chunk, _mm_set1_epi8(-64)));
+    }
+    __m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+    count += static_cast<size_t>(_mm_cvtsi128_si32(sums)) + static_cast<size_t>(_mm_extract_epi16(sums, 4));
+  }
+  return i;
+}
+#endif
+
+#if defined(MY_STRING_AVX2)
+__attribute__((target("avx2"))) __m256i in_range_avx2(__m256i chunk, byte first, byte width) {
+  __m256i biased = _mm256_add_epi8(chunk, _mm256_set1_epi8(static_cast<char>(0x80 - first)));
+  return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(-128 + width)), biased);
+}
+
+__attribute__((target("avx2"))) size_t flip_case_avx2(byte *data, size_t size, byte first) {
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    __m256i flip = _mm256_and_si256(in_range_avx2(chunk, first, 26), _mm256_set1_epi8(0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i), _mm256_xor_si256(chunk, flip));
+  }
+  return i;
+}
+
+__attribute__((target("avx2"))) size_t first_non_ascii_avx2(const byte *data, size_t pos, size_t size) {
+  for (; pos + 32 <= size; pos += 32) {
+    uint32_t mask = _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos)));
+    if (mask != 0) {
+      return pos + lowest_bit(mask);
+    }
+  }
+  return pos;
+}
+
+__attribute__((target("avx2"))) size_t count_continuations_avx2(const byte *data, size_t size, size_t &count) {
+  size_t i = 0;
+  while (i + 32 <= size) {
+    __m256i counters = _mm256_setzero_si256();
+    for (int round = 0; round < 255 && i + 32 <= size; ++round, i += 32) {
+      __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+      counters = _mm256_sub_epi8(counters, _mm256_cmpgt_epi8(_mm256_set1_epi8(-64), chunk));
+    }
+    __m256i sums = _mm256_sad_epu8(counters, _mm256_setzero_si256());
+    count += static_cast<size_t>(_mm256_extract_epi64(sums, 0)) + static_cast<size_t>(_mm256_extract_epi64(sums, 1))
+           + static_cast<size_t>(_mm256_extract_epi64(sums, 2)) + static_cast<size_t>(_mm256_extract_epi64(sums, 3));
+  }
+  return i;
+}
+#endif
+
+void flip_case(char *chars, size_t size, byte first) {
+  byte *data = reinterpret_cast<byte *>(chars);
+  size_t done = 0;
+#if defined(MY_STRING_AVX2)
+  if (use_avx2()) {
+    done = flip_case_avx2(data, size, first);
+  }
+#endif
+#if defined(MY_STRING_SSE2)
+  done += flip_case_sse2(data + done, size - done, first);
+#endif
+  flip_case_scalar(data + done, size - done, first);
+}
+
+size_t first_non_ascii(const byte *data, size_t pos, size_t size) {
+#if defined(MY_STRING_AVX2)
+  if (use_avx2()) {
+    pos = first_non_ascii_avx2(data, pos, size);
+  }
+#endif
+#if defined(MY_STRING_SSE2)
+  pos = first_non_ascii_sse2(data, pos, size);
+#endif
+  return first_non_ascii_scalar(data, pos, size);
+}
+
+bool is_continuation(byte chr) { return (chr & 0xC0) == 0x80; }
+
+// Validates the multi-byte sequence starting at `pos`, rejecting overlongs,
+// surrogates and code points above U+10FFFF. Returns its length, or 0.
+size_t sequence_length(const byte *data, size_t pos, size_t size) {
+  byte lead = data[pos];
+  size_t length;
+  byte low = 0x80;
+  byte high = 0xBF;
+  if (lead < 0xC2) {
+    return 0;
+  } else if (lead < 0xE0) {
+    length = 2;
+  } else if (lead < 0xF0) {
+    length = 3;
+    low = lead == 0xE0 ? 0xA0 : 0x80;
+    high = lead == 0xED ? 0x9F : 0xBF;
+  } else if (lead < 0xF5) {
+    length = 4;
+    low = lead == 0xF0 ? 0x90 : 0x80;
+    high = lead == 0xF4 ? 0x8F : 0xBF;
+  } else {
+    return 0;
+  }
+  if (size - pos < length || data[pos + 1] < low || data[pos + 1] > high) {
+    return 0;
+  }
+  for (size_t i = 2; i < length; ++i) {
+    if (!is_continuation(data[pos + i])) {
+      return 0;
+    }
+  }
+  return length;
+}
+}
+
+void my::ascii_to_lower(char *data, size_t size) { flip_case(data, size, 'A'); }
+
+void my::ascii_to_upper(char *data, size_t size) { flip_case(data, size, 'a'); }
+
+my::StringView my::trim(StringView str) {
+  const byte *data = reinterpret_cast<const byte *>(str.data());
+  size_t begin = 0;
+  size_t end = str.length();
+#if defined(MY_STRING_SSE2)
+  for (; begin + 16 <= end; begin += 16) {
+    uint32_t mask = space_mask_sse2(data + begin);
+    if (mask != 0xFFFF) {
+      begin += lowest_bit(~mask & 0xFFFF);
+      break;
+    }
+  }
+#endif
+  while (begin < end && is_space(data[begin])) {
+    ++begin;
+  }
+#if defined(MY_STRING_SSE2)
+  for (; end - begin >= 16; end -= 16) {
+    uint32_t mask = space_mask_sse2(data + end - 16);
+    if (mask != 0xFFFF) {
+      end -= 15 - highest_bit(~mask & 0xFFFF);
+      break;
+    }
+  }
+#endif
+  while (end > begin && is_space(data[end - 1])) {
+    --end;
+  }
+  return StringView(str.data() + begin, end - begin);
+}
+
+bool my::is_valid_utf8(StringView str) {
+  const byte *data = reinterpret_cast<const byte *>(str.data());
+  size_t size = str.length();
+  size_t pos = 0;
+  while (true) {
+    pos = first_non_ascii(data, pos, size);
+    if (pos == size) {
+      return true;
+    }
+    size_t length = sequence_length(data, pos, size);
+    if (length == 0) {
+      return false;
+    }
+    pos += length;
+  }
+}
+
+size_t my::count_code_points(StringView str) {
+  const byte *data = reinterpret_cast<const byte *>(str.data());
+  size_t size = str.length();
+  size_t continuations = 0;
+  size_t done = 0;
+#if defined(MY_STRING_AVX2)
+  if (use_avx2()) {
+    done = count_continuations_avx2(data, size, continuations);
+  }
+#endif
+#if defined(MY_STRING_SSE2)
+  done += count_continuations_sse2(data + done, size - done, continuations);
+#endif
+  continuations += count_continuations_scalar(data + done, size - done);
+  return size - continuations;
+}
+
+size_t my::count_occurrences(StringView str, StringView pattern) {
+  if (pattern.empty()) {
+    return 0;
+  }
+  size_t count = 0;
+  while (true) {
+    size_t pos = str.find(pattern);
+    if (pos == str.length()) {
+      return count;
+    }
+    ++count;
+    str = str.substr_view(pos + pattern.length());
+  }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+#include "string_view.hpp"
+
+// Whole-buffer text kernels. Each one picks AVX2, SSE2 or a scalar loop at
+// run time, so callers never branch on the instruction set themselves.
+namespace my {
+void ascii_to_lower(char* data, size_t size);
+
+void ascii_to_upper(char* data, size_t size);
+
+// Strips ' ', '\t', '\n', '\v', '\f' and '\r' from both ends without copying.
+StringView trim(StringView);
+
+bool is_valid_utf8(StringView);
+
+// Counts lead bytes; the result is only meaningful for valid UTF-8.
+size_t count_code_points(StringView);
+
+// Number of non-overlapping occurrences of a non-empty `pattern`.
+size_t count_occurrences(StringView str, StringView pattern);
+}
@@ -0,0 +1,155 @@
+#include "string_pool.hpp"
+
+#include <new>
+
+const char *my::InternedString::c_str() const { return entry_ == nullptr ? "" : entry_->data(); }
+
+size_t my::InternedString::length() const { return entry_ == nullptr ? 0 : entry_->size; }
+
+bool my::InternedString::empty() const { return length() == 0; }
+
+size_t my::InternedString::hash() const { return entry_ == nullptr ? StringView().hash() : entry_->hash; }
+
+my::StringPool::Table::Table(size_t capasity)
+    : mask(capasity - 1), slots(new std::atomic<const Entry *>[capasity]) {
+  for (size_t i = 0; i < capasity; ++i) {
+    slots[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+my::StringPool::Shard::Shard()
+    : table(nullptr), count(0), bytes_stored(0), curr(nullptr),
+      last(nullptr) {
+  tables.emplace_back(new Table(kInitialSlots));
+  table.store(tables.back().get(), std::memory_order_release);
+}
+
+const my::StringPool::Entry *my::StringPool::Shard::lookup(const Table *table, StringView str,
+                                                           size_t hash) const {
+  for (size_t i = hash & table->mask;; i = (i + 1) & table->mask) {
+    const Entry *entry = table->slots[i].load(std::memory_order_acquire);
+    if (entry == nullptr) {
+      return nullptr;
+    }
+    if (entry->hash == hash && StringView(entry->data(), entry->size) == str) {
+      return entry;
+    }
+  }
+}
+
+const my::StringPool::Entry *my::StringPool::Shard::insert(StringView str, size_t hash) {
+  std::lock_guard<std::mutex> lock(mutex);
+  const Entry *found = lookup(table.load(std::memory_order_relaxed), str, hash);
+  if (found != nullptr) {
+    return found;
+  }
+  if ((count + 1) * 4 > (table.load(std::memory_order_relaxed)->mask + 1) * 3) {
+    grow();
+  }
+
+  size_t amount = sizeof(Entry) + str.length() + 1;
+  amount = (amount + alignof(Entry) - 1) / alignof(Entry) * alignof(Entry);
+  char *place = reserve(amount);
+  Entry *entry = new (place) Entry{hash, str.length()};
+  if (str.length() != 0) {
+    memcpy(place + sizeof(Entry), str.data(), str.length());
+  }
+  place[sizeof(Entry) + str.length()] = '\0';
+
+  Table *current = table.load(std::memory_order_relaxed);
+  size_t i = hash & current->mask;
+  while (current->slots[i].load(std::memory_order_relaxed) != nullptr) {
+    i = (i + 1) & current->mask;
+  }
+  current->slots[i].store(entry, std::memory_order_release);
+  ++count;
+  bytes_stored += amount;
+  return entry;
+}
+
+// Old tables stay alive: lock-free readers may still be probing them.
+void my::StringPool::Shard::grow() {
+  Table *old = table.load(std::memory_order_relaxed);
+  tables.emplace_back(new Table((old->mask + 1) * 2));
+  Table *fresh = tables.back().get();
+  for (size_t j = 0; j <= old->mask; ++j) {
+    const Entry *entry = old->slots[j].load(std::memory_order_relaxed);
+    if (entry == nullptr) {
+      continue;
+    }
+    size_t i = entry->hash & fresh->mask;
+    while (fresh->slots[i].load(std::memory_order_relaxed) != nullptr) {
+      i = (i + 1) & fresh->mask;
+    }
+    fresh->slots[i].store(entry, std::memory_order_relaxed);
+  }
+  table.store(fresh, std::memory_order_release);
+}
+
+char *my::StringPool::Shard::reserve(size_t amount) {
+  if (static_cast<size_t>(last - curr) < amount) {
+    size_t size = amount > kBlockSize ? amount : kBlockSize;
+    blocks.emplace_back(new char[size]);
+    curr = blocks.back().get();
+    last = curr + size;
+  }
+  curr += amount;
+  return curr - amount;
+}
+
+my::StringPool::StringPool() : shards_(new Shard[kShards]), counters_(new Counters[kStripes]) {}
+
+my::StringPool::Shard &my::StringPool::shard_for(size_t hash) const {
+  return shards_[(hash >> (sizeof(size_t) * 8 - kShardBits)) & (kShards - 1)];
+}
+
+// Threads take stripes round-robin, so up to kStripes threads never share one.
+my::StringPool::Counters &my::StringPool::counters_for_thread() const {
+  static std::atomic<size_t> next_stripe{0};
+  thread_local size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) & (kStripes - 1);
+  return counters_[stripe];
+}
+
+my::InternedString my::StringPool::intern(StringView str) {
+  size_t hash = str.hash();
+  Shard &shard = shard_for(hash);
+  Counters &counters = counters_for_thread();
+  counters.interned.fetch_add(1, std::memory_order_relaxed);
+  counters.bytes_requested.fetch_add(str.length() + 1, std::memory_order_relaxed);
+  if (str.empty()) {
+    return InternedString();
+  }
+  const Entry *entry = shard.lookup(shard.table.load(std::memory_order_acquire), str, hash);
+  if (entry == nullptr) {
+    entry = shard.insert(str, hash);
+  }
+  return InternedString(entry);
+}
+
+my::InternedString my::StringPool::find(StringView str) const {
+  size_t hash = str.hash();
+  Shard &shard = shard_for(hash);
+  const Entry *entry = shard.lookup(shard.table.load(std::memory_order_acquire), str, hash);
+  if (entry == nullptr) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    entry = shard.lookup(shard.table.load(std::memory_order_relaxed), str, hash);
+  }
+  return InternedString(entry);
+}
+
+my::StringPool::Stats my::StringPool::stats() const {
+  Stats stats{0, 0, 0, 0};
+  for (size_t i = 0; i < kShards; ++i) {
+    Shard &shard = shards_[i];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    stats.unique += shard.count;
+    stats.bytes_stored += shard.bytes_stored;
+  }
+  for (size_t i = 0; i < kStripes; ++i) {
+    stats.interned += counters_[i].interned.load(std::memory_order_relaxed);
+    stats.bytes_requested += counters_[i].bytes_requested.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+my::StringPool::~StringPool() = default;
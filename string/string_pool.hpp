@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "string_view.hpp"
+
+namespace my {
+class StringPool;
+
+// Handle to pooled contents; equal contents from the same pool share one entry.
+// The empty string is never stored: a default-constructed handle is the
+// interned "" of every pool.
+class InternedString {
+ public:
+  InternedString() : entry_(nullptr) {}
+
+  const char* c_str() const;
+
+  size_t length() const;
+
+  bool empty() const;
+
+  size_t hash() const;
+
+  operator StringView() const { return StringView(c_str(), length()); }
+
+  // O(1): handles from the same pool are equal iff they point at the same entry.
+  friend bool operator==(InternedString left, InternedString right) { return left.entry_ == right.entry_; }
+
+  friend bool operator!=(InternedString left, InternedString right) { return left.entry_ != right.entry_; }
+
+  friend std::ostream& operator<<(std::ostream& out, InternedString str) { return out << StringView(str); }
+
+  friend class StringPool;
+
+ private:
+  struct Entry {
+    size_t hash;
+    size_t size;
+
+    const char* data() const { return reinterpret_cast<const char*>(this + 1); }
+  };
+
+  explicit InternedString(const Entry* entry) : entry_(entry) {}
+
+  const Entry* entry_;
+};
+
+// Interning is lock-free for contents already in the pool; new contents take
+// the owning shard's mutex. Entries live until the pool is destroyed.
+class StringPool {
+ public:
+  struct Stats {
+    size_t interned;
+    size_t unique;
+    size_t bytes_requested;
+    size_t bytes_stored;
+
+    size_t bytes_saved() const { return bytes_requested > bytes_stored ? bytes_requested - bytes_stored : 0; }
+  };
+
+  StringPool();
+
+  StringPool(const StringPool&) = delete;
+
+  StringPool& operator=(const StringPool&) = delete;
+
+  InternedString intern(StringView);
+
+  // Returns the empty handle when `str` was never interned; never inserts.
+  InternedString find(StringView) const;
+
+  Stats stats() const;
+
+  ~StringPool();
+
+ private:
+  using Entry = InternedString::Entry;
+
+  struct Table {
+    explicit Table(size_t capasity);
+
+    size_t mask;
+    std::unique_ptr<std::atomic<const Entry*>[]> slots;
+  };
+
+  // Each shard gets its own cache lines, so lookups in one shard never
+  // contend with inserts into a neighbour.
+  struct alignas(64) Shard {
+    Shard();
+
+    const Entry* lookup(const Table* table, StringView str, size_t hash) const;
+
+    const Entry* insert(StringView str, size_t hash);
+
+    void grow();
+
+    char* reserve(size_t amount);
+
+    std::atomic<Table*> table;
+    std::mutex mutex;
+    size_t count;
+    size_t bytes_stored;
+    std::vector<std::unique_ptr<Table>> tables;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* curr;
+    char* last;
+  };
+
+  // Request counters are striped by thread rather than by shard: a hit on a
+  // hot string then writes only to the calling thread's line.
+  struct alignas(64) Counters {
+    std::atomic<size_t> interned{0};
+    std::atomic<size_t> bytes_requested{0};
+  };
+
+  static const size_t kShardBits = 6;
+  static const size_t kShards = size_t(1) << kShardBits;
+  static const size_t kInitialSlots = 64;
+  static const size_t kBlockSize = 64 * 1024;
+  static const size_t kStripes = 64;
+
+  Shard& shard_for(size_t hash) const;
+
+  Counters& counters_for_thread() const;
+
+  std::unique_ptr<Shard[]> shards_;
+  std::unique_ptr<Counters[]> counters_;
+};
+}
+
+template <>
+struct std::hash<my::InternedString> {
+  size_t operator()(my::InternedString str) const noexcept { return str.hash(); }
+};
@@ -0,0 +1,167 @@
+#include "string_view.hpp"
+
+#include <stdexcept>
+
+namespace {
+const uint64_t kWySecret[4] = {
+    0xa0761d6478bd642fULL,
+    0xe7037ed1a0b428dbULL,
+    0x8ebc6af09c88c6e3ULL,
+    0x589965cc75374cc3ULL,
+};
+
+inline void wymum(uint64_t &left, uint64_t &right) {
+#if defined(__SIZEOF_INT128__)
+  __uint128_t product = static_cast<__uint128_t>(left) * right;
+  left = static_cast<uint64_t>(product);
+  right = static_cast<uint64_t>(product >> 64);
+#else
+  uint64_t ll = left & 0xffffffffULL, lh = left >> 32;
+  uint64_t rl = right & 0xffffffffULL, rh = right >> 32;
+  uint64_t low = ll * rl, mid1 = ll * rh, mid2 = lh * rl, high = lh * rh;
+  uint64_t carry = ((low >> 32) + (mid1 & 0xffffffffULL) + (mid2 & 0xffffffffULL)) >> 32;
+  left = low + (mid1 << 32) + (mid2 << 32);
+  right = high + (mid1 >> 32) + (mid2 >> 32) + carry;
+#endif
+}
+
+inline uint64_t wymix(uint64_t left, uint64_t right) {
+  wymum(left, right);
+  return left ^ right;
+}
+
+inline uint64_t read8(const unsigned char *ptr) {
+  uint64_t value;
+  memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+inline uint64_t read4(const unsigned char *ptr) {
+  uint32_t value;
+  memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+inline uint64_t read3(const unsigned char *ptr, size_t size) {
+  return (static_cast<uint64_t>(ptr[0]) << 16) | (static_cast<uint64_t>(ptr[size >> 1]) << 8) | ptr[size - 1];
+}
+
+uint64_t wyhash(const unsigned char *ptr, size_t size, uint64_t seed) {
+  seed ^= wymix(seed ^ kWySecret[0], kWySecret[1]);
+  uint64_t left;
+  uint64_t right;
+  if (size <= 16) {
+    if (size >= 4) {
+      left = (read4(ptr) << 32) | read4(ptr + ((size >> 3) << 2));
+      right = (read4(ptr + size - 4) << 32) | read4(ptr + size - 4 - ((size >> 3) << 2));
+    } else if (size > 0) {
+      left = read3(ptr, size);
+      right = 0;
+    } else {
+      left = right = 0;
+    }
+  } else {
+    size_t rest = size;
+    if (rest > 48) {
+      uint64_t seed1 = seed;
+      uint64_t seed2 = seed;
+      do {
+        seed = wymix(read8(ptr) ^ kWySecret[1], read8(ptr + 8) ^ seed);
+        seed1 = wymix(read8(ptr + 16) ^ kWySecret[2], read8(ptr + 24) ^ seed1);
+        seed2 = wymix(read8(ptr + 32) ^ kWySecret[3], read8(ptr + 40) ^ seed2);
+        ptr += 48;
+        rest -= 48;
+      } while (rest > 48);
+      seed ^= seed1 ^ seed2;
+    }
+    while (rest > 16) {
+      seed = wymix(read8(ptr) ^ kWySecret[1], read8(ptr + 8) ^ seed);
+      ptr += 16;
+      rest -= 16;
+    }
+    left = read8(ptr + rest - 16);
+    right = read8(ptr + rest - 8);
+  }
+  left ^= kWySecret[1];
+  right ^= seed;
+  wymum(left, right);
+  return wymix(left ^ kWySecret[0] ^ size, right ^ kWySecret[1]);
+}
+}
+
+my::StringView::StringView() : data_(""), size_(0) {}
+
+my::StringView::StringView(const char str[]) : data_(str), size_(strlen(str)) {}
+
+const char &my::StringView::front() const {
+  if (size_ == 0) {
+    throw std::out_of_range("StringView::front on empty view");
+  }
+  return data_[0];
+}
+
+const char &my::StringView::back() const {
+  if (size_ == 0) {
+    throw std::out_of_range("StringView::back on empty view");
+  }
+  return data_[size_ - 1];
+}
+
+my::StringView my::StringView::substr_view(size_t pos, size_t count) const {
+  if (pos > size_) {
+    throw std::out_of_range("StringView::substr_view position out of range");
+  }
+  if (count > size_ - pos) {
+    count = size_ - pos;
+  }
+  return StringView(data_ + pos, count);
+}
+
+size_t my::StringView::find(char chr) const {
+  if (size_ == 0) {
+    return size_;
+  }
+  const void *found = memchr(data_, chr, size_);
+  if (found == nullptr) {
+    return size_;
+  }
+  return static_cast<const char *>(found) - data_;
+}
+
+size_t my::StringView::find(StringView substr) const {
+  if (substr.size_ == 0) {
+    return 0;
+  }
+  if (substr.size_ > size_) {
+    return size_;
+  }
+  const char *last = data_ + (size_ - substr.size_);
+  for (const char *it = data_; it <= last; ++it) {
+    it = static_cast<const char *>(memchr(it, substr.data_[0], last - it + 1));
+    if (it == nullptr) {
+      break;
+    }
+    if (!memcmp(it + 1, substr.data_ + 1, substr.size_ - 1)) {
+      return it - data_;
+    }
+  }
+  return size_;
+}
+
+int my::StringView::compare(StringView other) const {
+  size_t common = size_ < other.size_ ? size_ : other.size_;
+  int result = common == 0 ? 0 : memcmp(data_, other.data_, common);
+  if (result != 0) {
+    return result;
+  }
+  if (size_ == other.size_) {
+    return 0;
+  }
+  return size_ < other.size_ ? -1 : 1;
+}
+
+size_t my::StringView::hash() const {
+  return static_cast<size_t>(wyhash(reinterpret_cast<const unsigned char *>(data_), size_, 0));
+}
+
+my::StringView::SplitRange my::StringView::split(char delim) const { return SplitRange(*this, delim); }
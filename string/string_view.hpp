@@ -0,0 +1,141 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <iterator>
+
+namespace my {
+class StringView {
+ public:
+  class SplitIterator;
+
+  class SplitRange;
+
+  static const size_t npos = SIZE_MAX;
+
+  StringView();
+
+  StringView(const char*);
+
+  StringView(const char* str, size_t size) : data_(str), size_(size) {}
+
+  const char& operator[](size_t index) const { return data_[index]; }
+
+  const char* data() const { return data_; }
+
+  size_t length() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  const char& front() const;
+
+  const char& back() const;
+
+  StringView substr_view(size_t pos, size_t count = npos) const;
+
+  size_t find(StringView) const;
+
+  size_t find(char) const;
+
+  int compare(StringView) const;
+
+  // wyhash: three independent 64x64->128 multiply lanes per 48-byte block.
+  size_t hash() const;
+
+  // Lazily yields the fields between `delim`s, empty ones included, so k
+  // delimiters always give k + 1 fields and an empty view gives one.
+  SplitRange split(char delim) const;
+
+  friend bool operator==(StringView left, StringView right) {
+    return left.size_ == right.size_ && (left.size_ == 0 || !memcmp(left.data_, right.data_, left.size_));
+  }
+
+  friend bool operator!=(StringView left, StringView right) { return !(left == right); }
+
+  friend std::strong_ordering operator<=>(StringView left, StringView right) { return left.compare(right) <=> 0; }
+
+  friend std::ostream& operator<<(std::ostream& out, StringView view) {
+    out.write(view.data_, static_cast<std::streamsize>(view.size_));
+    return out;
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+};
+
+class StringView::SplitIterator {
+ public:
+  using value_type = StringView;
+  using difference_type = std::ptrdiff_t;
+  using iterator_category = std::forward_iterator_tag;
+  using pointer = const StringView*;
+  using reference = StringView;
+
+  SplitIterator() : pos_(nullptr), token_end_(nullptr), end_(nullptr), delim_('\0') {}
+
+  SplitIterator(const char* begin, const char* end, char delim)
+      : pos_(begin), token_end_(next_delim(begin, end, delim)), end_(end), delim_(delim) {}
+
+  StringView operator*() const { return StringView(pos_, token_end_ - pos_); }
+
+  SplitIterator& operator++() {
+    if (token_end_ == end_) {
+      pos_ = nullptr;
+      return *this;
+    }
+    pos_ = token_end_ + 1;
+    token_end_ = next_delim(pos_, end_, delim_);
+    return *this;
+  }
+
+  SplitIterator operator++(int) {
+    SplitIterator buff(*this);
+    ++(*this);
+    return buff;
+  }
+
+  friend bool operator==(const SplitIterator& left, const SplitIterator& right) { return left.pos_ == right.pos_; }
+
+  friend bool operator!=(const SplitIterator& left, const SplitIterator& right) { return left.pos_ != right.pos_; }
+
+ private:
+  static const char* next_delim(const char* begin, const char* end, char delim) {
+    const void* found = begin == end ? nullptr : memchr(begin, delim, end - begin);
+    return found == nullptr ? end : static_cast<const char*>(found);
+  }
+
+  const char* pos_;
+  const char* token_end_;
+  const char* end_;
+  char delim_;
+};
+
+class StringView::SplitRange {
+ public:
+  SplitRange(StringView view, char delim) : view_(view), delim_(delim) {}
+
+  // A null pointer would read as the end iterator, so a null empty view
+  // starts from "" instead.
+  SplitIterator begin() const {
+    const char* data = view_.data_ != nullptr ? view_.data_ : "";
+    return SplitIterator(data, data + view_.size_, delim_);
+  }
+
+  SplitIterator end() const { return SplitIterator(); }
+
+ private:
+  StringView view_;
+  char delim_;
+};
+}
+
+template <>
+struct std::hash<my::StringView> {
+  size_t operator()(my::StringView view) const noexcept {
+    return view.hash();
+  }
+};
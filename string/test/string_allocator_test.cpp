@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <memory_resource>
+
+#include "string.hpp"
+
+namespace {
+// Stateful allocator that counts live bytes in its arena; allocators are
+// equal only when they share an arena.
+struct Arena {
+  size_t live = 0;
+  size_t allocations = 0;
+};
+
+template <typename T>
+struct CountingAllocator {
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::false_type;
+
+  explicit CountingAllocator(Arena* arena) : arena(arena) {}
+
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U>& other) : arena(other.arena) {}
+
+  T* allocate(size_t count) {
+    arena->live += count * sizeof(T);
+    ++arena->allocations;
+    return std::allocator<T>().allocate(count);
+  }
+
+  void deallocate(T* ptr, size_t count) {
+    arena->live -= count * sizeof(T);
+    std::allocator<T>().deallocate(ptr, count);
+  }
+
+  template <typename U>
+  bool operator==(const CountingAllocator<U>& other) const {
+    return arena == other.arena;
+  }
+
+  Arena* arena;
+};
+
+using CountedString = my::BasicString<CountingAllocator<char>>;
+}
+
+TEST(string_allocator, every_buffer_comes_from_the_allocator) {
+  Arena arena;
+  {
+    CountedString str("some text", CountingAllocator<char>(&arena));
+    for (int i = 0; i < 100; ++i) {
+      str.push_back('x');
+    }
+    while (str.length() > 1) {
+      str.pop_back();
+    }
+    str.replace_all("s", "sss");
+    str.clear();
+    EXPECT_EQ(arena.live, 0u);
+    str.push_back('y');
+    EXPECT_GT(arena.live, 0u);
+  }
+  EXPECT_EQ(arena.live, 0u);
+  EXPECT_GT(arena.allocations, 0u);
+}
+
+TEST(string_allocator, empty_string_does_not_allocate) {
+  Arena arena;
+  CountedString str{CountingAllocator<char>(&arena)};
+  EXPECT_TRUE(str.empty());
+  EXPECT_EQ(arena.allocations, 0u);
+}
+
+TEST(string_allocator, copy_keeps_the_source_allocator) {
+  Arena arena;
+  CountedString src("copied", CountingAllocator<char>(&arena));
+  CountedString copy(src);
+  EXPECT_EQ(copy.get_allocator().arena, &arena);
+  EXPECT_EQ(arena.allocations, 2u);
+}
+
+TEST(string_allocator, move_assignment_between_arenas_copies) {
+  Arena left_arena;
+  Arena right_arena;
+  CountedString left("left", CountingAllocator<char>(&left_arena));
+  CountedString right("right", CountingAllocator<char>(&right_arena));
+  left = std::move(right);
+  EXPECT_EQ(left, CountedString("right", CountingAllocator<char>(&left_arena)));
+  EXPECT_EQ(left.get_allocator().arena, &left_arena);
+  EXPECT_EQ(right_arena.live, 6u);
+}
+
+TEST(string_allocator, move_assignment_within_arena_steals) {
+  Arena arena;
+  CountedString left("left", CountingAllocator<char>(&arena));
+  CountedString right("right", CountingAllocator<char>(&arena));
+  size_t allocations = arena.allocations;
+  left = std::move(right);
+  EXPECT_EQ(arena.allocations, allocations);
+  EXPECT_EQ(arena.live, 6u);
+  EXPECT_TRUE(right.empty());
+}
+
+TEST(string_allocator, runs_on_a_monotonic_arena) {
+  char buffer[1024];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+  using PmrString = my::BasicString<std::pmr::polymorphic_allocator<char>>;
+  PmrString str("request-scoped", &arena);
+  str.push_back('!');
+  PmrString copy(my::StringView(str), &arena);
+  EXPECT_EQ(copy, str);
+  EXPECT_GE(my::StringView(str).data(), buffer);
+  EXPECT_LT(my::StringView(str).data(), buffer + sizeof(buffer));
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "string.hpp"
+
+namespace {
+my::String from(const std::string& str) { return my::String(my::StringView(str.data(), str.size())); }
+}
+
+TEST(string_hash, equal_strings_hash_equal) {
+  for (size_t length = 0; length < 200; ++length) {
+    std::string text(length, 'a');
+    for (size_t i = 0; i < length; ++i) {
+      text[i] = static_cast<char>('a' + i * 7 % 26);
+    }
+    my::String left = from(text);
+    my::String right = from(text);
+    EXPECT_EQ(std::hash<my::String>()(left), std::hash<my::String>()(right));
+    EXPECT_EQ(std::hash<my::String>()(left), std::hash<my::StringView>()(my::StringView(text.data(), length)));
+  }
+}
+
+TEST(string_hash, single_byte_changes_change_hash) {
+  // Covers the short paths and every lane of the 48-byte blocks.
+  std::string text(150, 'x');
+  size_t base = std::hash<my::String>()(from(text));
+  std::set<size_t> seen{base};
+  for (size_t i = 0; i < text.size(); ++i) {
+    std::string changed = text;
+    changed[i] = 'y';
+    size_t hash = std::hash<my::String>()(from(changed));
+    EXPECT_NE(hash, base) << "position " << i;
+    seen.insert(hash);
+  }
+  EXPECT_EQ(seen.size(), text.size() + 1);
+}
+
+TEST(string_hash, length_is_part_of_hash) {
+  EXPECT_NE(std::hash<my::String>()(from(std::string(3, '\0'))), std::hash<my::String>()(from(std::string(4, '\0'))));
+}
+
+TEST(string_compare, embedded_nul_bytes_count) {
+  my::String left = from(std::string("ab\0cd", 5));
+  my::String right = from(std::string("ab\0ce", 5));
+  EXPECT_NE(left, right);
+  EXPECT_LT(left, right);
+  EXPECT_EQ(left, from(std::string("ab\0cd", 5)));
+}
+
+TEST(string_compare, three_way_matches_std_string) {
+  const char* words[] = {"", "a", "ab", "abc", "abd", "b", "ba", "\xff", "zzzz"};
+  for (const char* left : words) {
+    for (const char* right : words) {
+      std::strong_ordering expected = std::string(left) <=> std::string(right);
+      EXPECT_EQ(my::String(left) <=> my::String(right), expected) << left << " vs " << right;
+      EXPECT_EQ(my::String(left) == my::String(right), std::is_eq(expected));
+    }
+  }
+}
+
+TEST(hashed_string, caches_hash_of_contents) {
+  my::HashedString key(my::String("cached key"));
+  EXPECT_EQ(key.hash(), std::hash<my::String>()(my::String("cached key")));
+  EXPECT_EQ(std::hash<my::HashedString>()(key), key.hash());
+  EXPECT_EQ(key, my::HashedString(my::String("cached key")));
+  EXPECT_NE(key, my::HashedString(my::String("other key")));
+}
+
+TEST(string_hash, works_as_unordered_map_key) {
+  std::unordered_map<my::String, int> map;
+  for (int i = 0; i < 1000; ++i) {
+    map.emplace(from("key-" + std::to_string(i)), i);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    auto it = map.find(from("key-" + std::to_string(i)));
+    ASSERT_NE(it, map.end());
+    EXPECT_EQ(it->second, i);
+  }
+  EXPECT_EQ(map.find(my::String("key-1000")), map.end());
+}
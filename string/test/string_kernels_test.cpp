@@ -0,0 +1,239 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "string_kernels.hpp"
+
+// Every kernel against a byte-at-a-time reference, for each length 0-100 and
+// several start offsets, so the vector loops and their 16- and 32-byte tails
+// all run on this host's widest instruction set.
+namespace {
+const size_t kMaxLength = 100;
+const size_t kOffsets = 4;
+
+char lower_reference(char chr) { return chr >= 'A' && chr <= 'Z' ? static_cast<char>(chr + 32) : chr; }
+
+char upper_reference(char chr) { return chr >= 'a' && chr <= 'z' ? static_cast<char>(chr - 32) : chr; }
+
+bool space_reference(char chr) { return chr == ' ' || (chr >= '\t' && chr <= '\r'); }
+
+std::string trim_reference(const std::string& str) {
+  size_t begin = 0;
+  size_t end = str.size();
+  while (begin < end && space_reference(str[begin])) {
+    ++begin;
+  }
+  while (end > begin && space_reference(str[end - 1])) {
+    --end;
+  }
+  return str.substr(begin, end - begin);
+}
+
+// Decodes each sequence and checks the code point against its length's range.
+bool utf8_reference(const std::string& str) {
+  size_t pos = 0;
+  while (pos < str.size()) {
+    uint8_t lead = static_cast<uint8_t>(str[pos]);
+    size_t length = lead < 0x80 ? 1 : lead >> 5 == 0x6 ? 2 : lead >> 4 == 0xE ? 3 : lead >> 3 == 0x1E ? 4 : 0;
+    if (length == 0 || pos + length > str.size()) {
+      return false;
+    }
+    uint32_t code = length == 1 ? lead : lead & (0x7F >> length);
+    for (size_t i = 1; i < length; ++i) {
+      uint8_t next = static_cast<uint8_t>(str[pos + i]);
+      if ((next & 0xC0) != 0x80) {
+        return false;
+      }
+      code = code << 6 | (next & 0x3F);
+    }
+    const uint32_t kMinimum[] = {0, 0, 0x80, 0x800, 0x10000};
+    if (code < kMinimum[length] || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) {
+      return false;
+    }
+    pos += length;
+  }
+  return true;
+}
+
+size_t code_points_reference(const std::string& str) {
+  size_t count = 0;
+  for (char chr : str) {
+    count += (static_cast<uint8_t>(chr) & 0xC0) != 0x80;
+  }
+  return count;
+}
+
+// Random bytes drawn from `alphabet`, placed at `offset` in a larger buffer.
+std::string random_text(std::mt19937& rng, size_t length, const std::string& alphabet) {
+  std::string text;
+  for (size_t i = 0; i < length; ++i) {
+    text.push_back(alphabet[rng() % alphabet.size()]);
+  }
+  return text;
+}
+
+const std::string kMixedCase = "abcxyzABCXYZ@[`{09 \t~\x7f\x80\xc0\xe1\xfa";
+const std::string kSpaces = " \t\n\v\f\r\x1f!\xa0x";
+const std::string kUtf8Pieces[] = {"a", "~", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xf4\x8f\xbf\xbf"};
+}
+
+TEST(string_kernels, case_conversion_matches_reference) {
+  std::mt19937 rng(1);
+  for (size_t length = 0; length <= kMaxLength; ++length) {
+    for (size_t offset = 0; offset < kOffsets; ++offset) {
+      std::string text = random_text(rng, length, kMixedCase);
+      std::string buffer(offset, '#');
+      buffer += text;
+      buffer += "#";
+      std::string lower = buffer;
+      std::string upper = buffer;
+      my::ascii_to_lower(lower.data() + offset, length);
+      my::ascii_to_upper(upper.data() + offset, length);
+      std::string expected_lower = buffer;
+      std::string expected_upper = buffer;
+      for (size_t i = offset; i < offset + length; ++i) {
+        expected_lower[i] = lower_reference(buffer[i]);
+        expected_upper[i] = upper_reference(buffer[i]);
+      }
+      ASSERT_EQ(lower, expected_lower) << "length " << length << " offset " << offset;
+      ASSERT_EQ(upper, expected_upper) << "length " << length << " offset " << offset;
+    }
+  }
+}
+
+TEST(string_kernels, trim_matches_reference) {
+  std::mt19937 rng(2);
+  for (size_t length = 0; length <= kMaxLength; ++length) {
+    for (size_t offset = 0; offset < kOffsets; ++offset) {
+      // Space runs of random length around a core that may itself hold spaces.
+      size_t before = rng() % (length + 1);
+      size_t after = rng() % (length - before + 1);
+      std::string text;
+      for (size_t i = 0; i < length; ++i) {
+        bool padding = i < before || i >= length - after;
+        text.push_back(padding ? " \t\n\v\f\r"[rng() % 6] : kSpaces[rng() % kSpaces.size()]);
+      }
+      std::string buffer = std::string(offset, 'x') + text + "x";
+      my::StringView trimmed = my::trim(my::StringView(buffer.data() + offset, length));
+      std::string expected = trim_reference(text);
+      ASSERT_EQ(std::string(trimmed.data(), trimmed.length()), expected) << "length " << length;
+      if (!expected.empty()) {
+        ASSERT_EQ(trimmed.data(), buffer.data() + offset + text.find(expected));
+      }
+    }
+  }
+}
+
+TEST(string_kernels, trim_all_space_and_no_space) {
+  for (size_t length = 0; length <= kMaxLength; ++length) {
+    std::string spaces(length, ' ');
+    EXPECT_TRUE(my::trim(my::StringView(spaces.data(), length)).empty());
+    std::string solid(length, 'x');
+    EXPECT_EQ(my::trim(my::StringView(solid.data(), length)).length(), length);
+  }
+}
+
+TEST(string_kernels, utf8_matches_reference_on_valid_text) {
+  std::mt19937 rng(3);
+  for (size_t length = 0; length <= kMaxLength; ++length) {
+    for (size_t offset = 0; offset < kOffsets; ++offset) {
+      std::string text;
+      while (text.size() < length) {
+        text += kUtf8Pieces[rng() % 6];
+      }
+      std::string buffer = std::string(offset, 'x') + text;
+      my::StringView view(buffer.data() + offset, text.size());
+      ASSERT_TRUE(utf8_reference(text));
+      ASSERT_TRUE(my::is_valid_utf8(view)) << "length " << text.size();
+      ASSERT_EQ(my::count_code_points(view), code_points_reference(text));
+    }
+  }
+}
+
+TEST(string_kernels, utf8_matches_reference_on_random_bytes) {
+  std::mt19937 rng(4);
+  std::string alphabet = "ab";
+  for (int byte = 0x80; byte <= 0xFF; ++byte) {
+    alphabet.push_back(static_cast<char>(byte));
+  }
+  for (size_t length = 0; length <= kMaxLength; ++length) {
+    for (int trial = 0; trial < 20; ++trial) {
+      std::string text = random_text(rng, length, alphabet);
+      my::StringView view(text.data(), text.size());
+      ASSERT_EQ(my::is_valid_utf8(view), utf8_reference(text));
+      ASSERT_EQ(my::count_code_points(view), code_points_reference(text));
+    }
+  }
+}
+
+TEST(string_kernels, utf8_edge_cases) {
+  struct Case {
+    std::string bytes;
+    bool valid;
+  };
+  std::vector<Case> cases = {
+      {"\x7f", true},
+      {"\xc2\x80", true},
+      {"\xc0\x80", false},              // overlong NUL
+      {"\xc1\xbf", false},              // overlong 2-byte
+      {"\xe0\x9f\xbf", false},          // overlong 3-byte
+      {"\xe0\xa0\x80", true},           // U+0800
+      {"\xf0\x8f\xbf\xbf", false},      // overlong 4-byte
+      {"\xf0\x90\x80\x80", true},       // U+10000
+      {"\xed\x9f\xbf", true},           // U+D7FF
+      {"\xed\xa0\x80", false},          // U+D800, first surrogate
+      {"\xed\xbf\xbf", false},          // U+DFFF, last surrogate
+      {"\xee\x80\x80", true},           // U+E000
+      {"\xf4\x8f\xbf\xbf", true},       // U+10FFFF
+      {"\xf4\x90\x80\x80", false},      // U+110000
+      {"\xf5\x80\x80\x80", false},
+      {"\xff", false},
+      {"\x80", false},                  // lone continuation
+      {"\xc3", false},                  // truncated 2-byte
+      {"\xe2\x82", false},              // truncated 3-byte
+      {"\xf0\x9f\x98", false},          // truncated 4-byte
+      {"\xe2\x28\xa1", false},          // bad continuation
+  };
+  for (const Case& test : cases) {
+    ASSERT_EQ(utf8_reference(test.bytes), test.valid);
+    // Placed at every position of a 100-byte ASCII run, and at its very end,
+    // so the scalar fallback is reached from each vector tail.
+    for (size_t prefix = 0; prefix <= kMaxLength; ++prefix) {
+      std::string text = std::string(prefix, 'a') + test.bytes;
+      EXPECT_EQ(my::is_valid_utf8(my::StringView(text.data(), text.size())), test.valid)
+          << "prefix " << prefix << " case " << testing::PrintToString(test.bytes);
+      std::string middle = text + "tail";
+      EXPECT_EQ(my::is_valid_utf8(my::StringView(middle.data(), middle.size())), test.valid);
+    }
+  }
+}
+
+TEST(string_kernels, truncated_sequence_at_buffer_end) {
+  // The bytes after the view are a valid continuation; they must not be read.
+  std::string buffer = std::string(40, 'a') + "\xe2\x82\xac";
+  for (size_t cut = 1; cut < 3; ++cut) {
+    my::StringView view(buffer.data(), buffer.size() - cut);
+    EXPECT_FALSE(my::is_valid_utf8(view));
+  }
+  EXPECT_TRUE(my::is_valid_utf8(my::StringView(buffer.data(), buffer.size())));
+}
+
+TEST(string_kernels, count_occurrences_matches_reference) {
+  std::mt19937 rng(5);
+  for (size_t length = 0; length <= kMaxLength; ++length) {
+    std::string text = random_text(rng, length, "aab");
+    for (const std::string pattern : {"a", "aa", "ab", "aba", "b"}) {
+      size_t expected = 0;
+      for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + pattern.size())) {
+        ++expected;
+      }
+      ASSERT_EQ(my::count_occurrences(my::StringView(text.data(), text.size()),
+                                      my::StringView(pattern.data(), pattern.size())),
+                expected);
+    }
+  }
+  EXPECT_EQ(my::count_occurrences("abc", ""), 0u);
+}
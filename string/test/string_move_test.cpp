@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "string.hpp"
+
+namespace {
+my::StringView view(const my::String& str) { return str; }
+}
+
+TEST(string_move, constructor_steals_buffer) {
+  my::String src("hello world");
+  const char* buffer = view(src).data();
+  my::String dst(std::move(src));
+  EXPECT_EQ(view(dst).data(), buffer);
+  EXPECT_EQ(dst, my::String("hello world"));
+  EXPECT_TRUE(src.empty());
+  EXPECT_EQ(*view(src).data(), '\0');
+}
+
+TEST(string_move, assignment_steals_buffer) {
+  my::String src("payload");
+  my::String dst("old contents");
+  const char* buffer = view(src).data();
+  dst = std::move(src);
+  EXPECT_EQ(view(dst).data(), buffer);
+  EXPECT_EQ(dst, my::String("payload"));
+  EXPECT_TRUE(src.empty());
+}
+
+TEST(string_move, self_move_assignment) {
+  my::String str("self");
+  my::String& alias = str;
+  str = std::move(alias);
+  EXPECT_EQ(str, my::String("self"));
+}
+
+TEST(string_move, operations_are_noexcept) {
+  EXPECT_TRUE(std::is_nothrow_move_constructible_v<my::String>);
+  EXPECT_TRUE(std::is_nothrow_move_assignable_v<my::String>);
+  EXPECT_TRUE(std::is_nothrow_swappable_v<my::String>);
+}
+
+TEST(string_copy, assignment_is_deep) {
+  my::String src("abc");
+  my::String dst;
+  dst = src;
+  dst[0] = 'x';
+  EXPECT_EQ(src, my::String("abc"));
+  EXPECT_EQ(dst, my::String("xbc"));
+}
+
+TEST(string_copy, assignment_reuses_capacity) {
+  my::String dst("a long enough buffer");
+  const char* buffer = view(dst).data();
+  my::String shorter("shorter");
+  my::String tiny("tiny");
+  dst = shorter;
+  dst = tiny;
+  EXPECT_EQ(view(dst).data(), buffer);
+  EXPECT_EQ(dst, tiny);
+}
+
+TEST(string_swap, exchanges_buffers) {
+  my::String left("left");
+  my::String right("right side");
+  const char* left_buffer = view(left).data();
+  const char* right_buffer = view(right).data();
+  swap(left, right);
+  EXPECT_EQ(view(left).data(), right_buffer);
+  EXPECT_EQ(view(right).data(), left_buffer);
+  EXPECT_EQ(left, my::String("right side"));
+  EXPECT_EQ(right, my::String("left"));
+}
+
+TEST(string_buffer, adopt_takes_ownership) {
+  std::allocator<char> alloc;
+  char* buffer = alloc.allocate(16);
+  memcpy(buffer, "adopted", 7);
+  my::String str("replaced");
+  str.adopt(buffer, 7, 16);
+  EXPECT_EQ(view(str).data(), buffer);
+  EXPECT_EQ(str, my::String("adopted"));
+  str.push_back('!');
+  EXPECT_EQ(str, my::String("adopted!"));
+}
+
+TEST(string_buffer, adopt_needs_room_for_terminator) {
+  std::allocator<char> alloc;
+  char* buffer = alloc.allocate(4);
+  my::String str("kept");
+  EXPECT_THROW(str.adopt(buffer, 4, 4), std::length_error);
+  EXPECT_EQ(str, my::String("kept"));
+  alloc.deallocate(buffer, 4);
+}
+
+TEST(string_buffer, release_hands_out_buffer) {
+  my::String str("released");
+  const char* expected = view(str).data();
+  size_t capasity = 0;
+  char* buffer = str.release(capasity);
+  EXPECT_EQ(buffer, expected);
+  EXPECT_STREQ(buffer, "released");
+  EXPECT_GT(capasity, strlen("released"));
+  EXPECT_TRUE(str.empty());
+  str.get_allocator().deallocate(buffer, capasity);
+}
+
+TEST(string_buffer, release_of_empty_string_allocates) {
+  my::String str;
+  size_t capasity = 0;
+  char* buffer = str.release(capasity);
+  EXPECT_EQ(capasity, 1u);
+  EXPECT_EQ(buffer[0], '\0');
+  str.get_allocator().deallocate(buffer, capasity);
+}
+
+TEST(string_empty, sentinel_is_not_shared_through_writes) {
+  my::String first;
+  my::String second;
+  first[0] = 'x';
+  EXPECT_EQ(*view(second).data(), '\0');
+  EXPECT_EQ(*view(my::String()).data(), '\0');
+}
+
+TEST(string_move, vector_growth_relocates_without_copies) {
+  std::vector<my::String> strings;
+  strings.emplace_back("first element, long enough to live on the heap");
+  const char* buffer = view(strings[0]).data();
+  for (int i = 0; i < 1000; ++i) {
+    strings.emplace_back("filler");
+  }
+  EXPECT_EQ(view(strings[0]).data(), buffer);
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "string.hpp"
+#include "string_pool.hpp"
+
+namespace {
+std::vector<std::string> make_keys(size_t count) {
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < count; ++i) {
+    keys.push_back("key-" + std::to_string(i * 7919) + "-" + std::string(i % 40, 'p'));
+  }
+  return keys;
+}
+}
+
+TEST(string_pool, equal_contents_share_one_entry) {
+  my::StringPool pool;
+  std::string first = "shared contents";
+  std::string second = first;
+  my::InternedString a = pool.intern(my::StringView(first.data(), first.size()));
+  my::InternedString b = pool.intern(my::StringView(second.data(), second.size()));
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(a.c_str(), b.c_str());
+  EXPECT_NE(a.c_str(), first.data());
+  EXPECT_EQ(my::StringView(a), my::StringView("shared contents"));
+  EXPECT_EQ(a.length(), first.size());
+  EXPECT_EQ(a.hash(), my::StringView("shared contents").hash());
+}
+
+TEST(string_pool, different_contents_differ) {
+  my::StringPool pool;
+  EXPECT_NE(pool.intern("alpha"), pool.intern("alphb"));
+  EXPECT_NE(pool.intern("a"), pool.intern(my::StringView("a\0", 2)));
+}
+
+TEST(string_pool, handle_equality_is_pointer_equality) {
+  my::StringPool pool;
+  my::InternedString a = pool.intern("x");
+  my::InternedString b = a;
+  static_assert(sizeof(my::InternedString) == sizeof(void*));
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(a.c_str(), b.c_str());
+}
+
+TEST(string_pool, default_handle_is_the_empty_string) {
+  my::StringPool pool;
+  my::InternedString none;
+  EXPECT_EQ(none, pool.intern(""));
+  EXPECT_EQ(none, pool.intern(my::StringView()));
+  EXPECT_EQ(none, pool.find(""));
+  EXPECT_TRUE(none.empty());
+  EXPECT_STREQ(none.c_str(), "");
+  EXPECT_EQ(none.hash(), pool.intern("").hash());
+  EXPECT_EQ(pool.stats().unique, 0u);
+}
+
+TEST(string_pool, find_never_inserts) {
+  my::StringPool pool;
+  EXPECT_EQ(pool.find("missing"), my::InternedString());
+  EXPECT_EQ(pool.stats().unique, 0u);
+  my::InternedString added = pool.intern("present");
+  EXPECT_EQ(pool.find("present"), added);
+}
+
+TEST(string_pool, stats_count_requests_and_savings) {
+  my::StringPool pool;
+  for (int i = 0; i < 10; ++i) {
+    pool.intern("repeated");
+  }
+  pool.intern("once");
+  my::StringPool::Stats stats = pool.stats();
+  EXPECT_EQ(stats.interned, 11u);
+  EXPECT_EQ(stats.unique, 2u);
+  EXPECT_EQ(stats.bytes_requested, 10 * sizeof("repeated") + sizeof("once"));
+  EXPECT_GE(stats.bytes_stored, sizeof("repeated") + sizeof("once"));
+  EXPECT_EQ(stats.bytes_saved(), stats.bytes_requested - stats.bytes_stored);
+}
+
+TEST(string_pool, survives_table_growth) {
+  my::StringPool pool;
+  std::vector<std::string> keys = make_keys(20'000);
+  std::vector<my::InternedString> handles;
+  for (const std::string& key : keys) {
+    handles.push_back(pool.intern(my::StringView(key.data(), key.size())));
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(pool.find(my::StringView(keys[i].data(), keys[i].size())), handles[i]);
+    EXPECT_EQ(my::StringView(handles[i]), my::StringView(keys[i].data(), keys[i].size()));
+  }
+  EXPECT_EQ(pool.stats().unique, keys.size());
+}
+
+TEST(string_pool, threads_interning_the_same_keys_agree) {
+  const size_t kThreads = 8;
+  my::StringPool pool;
+  std::vector<std::string> keys = make_keys(5000);
+  std::vector<std::vector<my::InternedString>> results(kThreads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (size_t round = 0; round < keys.size(); ++round) {
+        // Each thread walks the keys from a different offset, so first
+        // inserts of a key race between threads.
+        size_t i = (round + t * 613) % keys.size();
+        results[t].push_back(pool.intern(my::StringView(keys[i].data(), keys[i].size())));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (size_t t = 0; t < kThreads; ++t) {
+    for (size_t round = 0; round < keys.size(); ++round) {
+      size_t i = (round + t * 613) % keys.size();
+      EXPECT_EQ(results[t][round], pool.find(my::StringView(keys[i].data(), keys[i].size())));
+    }
+  }
+  my::StringPool::Stats stats = pool.stats();
+  EXPECT_EQ(stats.unique, keys.size());
+  EXPECT_EQ(stats.interned, kThreads * keys.size());
+}
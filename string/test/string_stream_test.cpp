@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "string.hpp"
+
+namespace {
+std::string to_std(const my::String& str) {
+  my::StringView view = str;
+  return std::string(view.data(), view.length());
+}
+
+// Reads every token both ways and checks contents and stream state match.
+void expect_tokens_match(const std::string& input, std::streamsize width = 0) {
+  std::istringstream mine(input);
+  std::istringstream theirs(input);
+  while (true) {
+    my::String token;
+    std::string expected;
+    mine.width(width);
+    theirs.width(width);
+    bool mine_ok = static_cast<bool>(mine >> token);
+    bool theirs_ok = static_cast<bool>(theirs >> expected);
+    ASSERT_EQ(mine_ok, theirs_ok);
+    EXPECT_EQ(mine.rdstate(), theirs.rdstate());
+    EXPECT_EQ(mine.width(), theirs.width());
+    if (!theirs_ok) {
+      break;
+    }
+    EXPECT_EQ(to_std(token), expected);
+  }
+}
+
+void expect_lines_match(const std::string& input, char delim = '\n') {
+  std::istringstream mine(input);
+  std::istringstream theirs(input);
+  while (true) {
+    my::String line;
+    std::string expected;
+    bool mine_ok = static_cast<bool>(my::getline(mine, line, delim));
+    bool theirs_ok = static_cast<bool>(std::getline(theirs, expected, delim));
+    ASSERT_EQ(mine_ok, theirs_ok);
+    EXPECT_EQ(mine.rdstate(), theirs.rdstate());
+    if (!theirs_ok) {
+      break;
+    }
+    EXPECT_EQ(to_std(line), expected);
+  }
+}
+}
+
+TEST(string_stream, tokens_match_std_string) {
+  expect_tokens_match("alpha  beta\tgamma\n\ndelta ");
+  expect_tokens_match("trailing-token");
+  expect_tokens_match("   ");
+  expect_tokens_match("");
+}
+
+TEST(string_stream, tokens_longer_than_a_chunk) {
+  for (size_t length : {255u, 256u, 257u, 511u, 512u, 513u, 5000u}) {
+    std::string token(length, 'x');
+    token[length / 2] = 'y';
+    expect_tokens_match(token + " " + token + "\n" + token);
+  }
+}
+
+TEST(string_stream, width_limits_one_extraction) {
+  expect_tokens_match("abcdefghij klm", 4);
+  expect_tokens_match(std::string(600, 'q'), 300);
+
+  std::istringstream in("abcdefgh");
+  my::String token;
+  in.width(3);
+  in >> token;
+  EXPECT_EQ(to_std(token), "abc");
+  EXPECT_EQ(in.width(), 0);
+  in >> token;
+  EXPECT_EQ(to_std(token), "defgh");
+}
+
+TEST(string_stream, eof_and_fail_after_last_token) {
+  std::istringstream in("last");
+  my::String token;
+  EXPECT_TRUE(in >> token);
+  EXPECT_TRUE(in.eof());
+  EXPECT_FALSE(in.fail());
+  EXPECT_FALSE(in >> token);
+  EXPECT_TRUE(in.eof());
+  EXPECT_TRUE(in.fail());
+}
+
+TEST(string_stream, getline_matches_std_string) {
+  expect_lines_match("one\n\nthree\n");
+  expect_lines_match("\n\n\n");
+  expect_lines_match("no newline at end");
+  expect_lines_match("a;b;;c", ';');
+  expect_lines_match(std::string(700, 'l') + "\n" + std::string(256, 'm') + "\n");
+  expect_lines_match("");
+}
+
+TEST(string_stream, getline_empty_line_is_success) {
+  std::istringstream in("\nnext");
+  my::String line("previous contents");
+  EXPECT_TRUE(my::getline(in, line));
+  EXPECT_TRUE(line.empty());
+  EXPECT_FALSE(in.eof());
+}
+
+TEST(string_stream, reuses_non_empty_destination) {
+  std::istringstream in("short " + std::string(300, 'z') + " x\nrest of line\n");
+  my::String str("a destination that already holds a long value");
+  in >> str;
+  EXPECT_EQ(to_std(str), "short");
+  in >> str;
+  EXPECT_EQ(to_std(str), std::string(300, 'z'));
+  in >> str;
+  EXPECT_EQ(to_std(str), "x");
+  in.get();
+  my::getline(in, str);
+  EXPECT_EQ(to_std(str), "rest of line");
+}
+
+TEST(string_stream, failed_extraction_clears_destination) {
+  std::istringstream in("   ");
+  my::String str("stale");
+  std::string expected("stale");
+  std::istringstream reference("   ");
+  in >> str;
+  reference >> expected;
+  EXPECT_EQ(to_std(str), expected);
+}
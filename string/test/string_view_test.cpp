@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "string_view.hpp"
+
+namespace {
+std::vector<std::string> fields(my::StringView view, char delim) {
+  std::vector<std::string> result;
+  for (my::StringView field : view.split(delim)) {
+    result.emplace_back(field.data(), field.length());
+  }
+  return result;
+}
+}
+
+TEST(string_view_split, keeps_empty_and_trailing_fields) {
+  EXPECT_EQ(fields("a,,b,", ','), (std::vector<std::string>{"a", "", "b", ""}));
+  EXPECT_EQ(fields(",a", ','), (std::vector<std::string>{"", "a"}));
+  EXPECT_EQ(fields(",,", ','), (std::vector<std::string>{"", "", ""}));
+  EXPECT_EQ(fields("no delimiter", ','), std::vector<std::string>{"no delimiter"});
+}
+
+TEST(string_view_split, empty_view_gives_one_empty_field) {
+  EXPECT_EQ(fields("", ','), std::vector<std::string>{""});
+  EXPECT_EQ(fields(my::StringView(), ','), std::vector<std::string>{""});
+  EXPECT_EQ(fields(my::StringView(nullptr, 0), ','), std::vector<std::string>{""});
+}
+
+TEST(string_view_split, fields_point_into_the_source) {
+  const char* text = "key=value";
+  std::vector<my::StringView> parts;
+  for (my::StringView part : my::StringView(text).split('=')) {
+    parts.push_back(part);
+  }
+  ASSERT_EQ(parts.size(), 2u);
+  EXPECT_EQ(parts[0].data(), text);
+  EXPECT_EQ(parts[1].data(), text + 4);
+}
+
+TEST(string_view_split, splits_on_nul) {
+  my::StringView view("a\0b", 3);
+  EXPECT_EQ(fields(view, '\0'), (std::vector<std::string>{"a", "b"}));
+}
+
+TEST(string_view_substr, clamps_count_and_checks_position) {
+  my::StringView view("hello");
+  EXPECT_EQ(view.substr_view(1, 3), my::StringView("ell"));
+  EXPECT_EQ(view.substr_view(2), my::StringView("llo"));
+  EXPECT_EQ(view.substr_view(3, 100), my::StringView("lo"));
+  EXPECT_TRUE(view.substr_view(5).empty());
+  EXPECT_THROW(static_cast<void>(view.substr_view(6)), std::out_of_range);
+  EXPECT_THROW(static_cast<void>(my::StringView().substr_view(1)), std::out_of_range);
+}
+
+TEST(string_view_find, not_found_returns_length) {
+  my::StringView view("abcabc");
+  EXPECT_EQ(view.find("cab"), 2u);
+  EXPECT_EQ(view.find("abd"), view.length());
+  EXPECT_EQ(view.find("abcabcabc"), view.length());
+  EXPECT_EQ(view.find(""), 0u);
+  EXPECT_EQ(view.find('c'), 2u);
+  EXPECT_EQ(view.find('z'), view.length());
+  EXPECT_EQ(my::StringView().find('a'), 0u);
+}
+
+TEST(string_view_find, embedded_nul_bytes) {
+  my::StringView view("ab\0cd\0ef", 8);
+  EXPECT_EQ(view.find('\0'), 2u);
+  EXPECT_EQ(view.find(my::StringView("\0ef", 3)), 5u);
+  EXPECT_EQ(view.find(my::StringView("d\0e", 3)), 4u);
+  EXPECT_EQ(view.find(my::StringView("\0\0", 2)), view.length());
+  EXPECT_EQ(view.find(my::StringView("b\0c", 3)), 1u);
+  // A C-string needle stops at its first NUL.
+  EXPECT_EQ(view.find("cd"), 3u);
+}
+
+TEST(string_view_find, match_at_the_end) {
+  my::StringView view("xxxxxxxxy");
+  EXPECT_EQ(view.find("xy"), 7u);
+  EXPECT_EQ(view.find("y"), 8u);
+}
+
+TEST(string_view_compare, embedded_nul_bytes) {
+  my::StringView shorter("a\0", 2);
+  my::StringView longer("a\0b", 3);
+  EXPECT_LT(shorter, longer);
+  EXPECT_NE(shorter, my::StringView("a"));
+  EXPECT_EQ(longer, my::StringView("a\0b", 3));
+}